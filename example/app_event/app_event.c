@@ -7,8 +7,14 @@
  *
  * Copyright (c) 2024 by ${git_name_email}, All Rights Reserved.
  */
+#define K_LOG_MODULE app_event
 #include "app_event.h"
 
+/* debug messages of the timer ISR are compiled in, enable them at run time
+ * with k_log_module_level_set(&k_log_module_app_event, K_LOG_SEV_DEBUG)
+ */
+K_LOG_MODULE_DEFINE(app_event, K_LOG_SEV_INFO);
+
 struct context_data {
     uint8_t id;
     char *name;
@@ -25,6 +31,15 @@ static void event_handler_test(const AppEvent_t *event) {
     }
 }
 
+static void app_event_dispatch(k_msgq_t *msgq, void *msg) {
+    const AppEvent_t *event = (const AppEvent_t *)msg;
+    ARG_UNUSED(msgq);
+
+    if (event->handler) {
+        event->handler(event);
+    }
+}
+
 static void k_work_user_test_handler(struct k_work_user *work) {
     struct context_data *ctx = (struct context_data *)work->context;
     K_LOG_INFO("%s workhandler", ctx->name);
@@ -36,11 +51,12 @@ static void k_timer_test_callback(k_timer_t *timer) {
 
     /* work test, submit in ISR */
     ctx->data++;
+    K_LOG_DEBUG("%s tick %u", ctx->name, (unsigned int)ctx->data);
     ctx->work.context = ctx;
     ctx->work.handler = k_work_user_test_handler;
     err = k_work_user_submit(&ctx->work);
     if (0 != err) {
-        K_LOG_ERROR("k_work_user_submit failed %d! %s", err, ctx->name);
+        K_LOG_ERROR_RATELIMIT("k_work_user_submit failed %d! %s", err, ctx->name);
     }
 
     /* event messages test, put in ISR */
@@ -50,7 +66,7 @@ static void k_timer_test_callback(k_timer_t *timer) {
     event.TimerEvent.context = timer->user_data;
     err = k_msgq_put(&sEventMsgq, &event);
     if (0 != err) {
-        K_LOG_ERROR("k_msgq_put failed %d! %s", err, ctx->name);
+        K_LOG_ERROR_RATELIMIT("k_msgq_put failed %d! %s", err, ctx->name);
     }
 }
 
@@ -74,18 +90,9 @@ void app_event_test(void) {
 
     K_LOG_INFO("timer start !!!");
 
-    while (1) {
-        /* main task */
-        AppEvent_t event;
-        if (0 == k_msgq_get(&sEventMsgq, &event)) {
-            if (event.handler)
-                event.handler(&event);
-        }
-
-        if (0 == k_work_user_wait()) {
-            continue;
-        } else {
-            /* PM */
-        }
-    }
+    /* main task: events before work, both dispatched by k_run() */
+    static k_run_src_t sEventSrc, sWorkSrc;
+    k_run_add_msgq(&sEventSrc, 0, 4, &sEventMsgq, app_event_dispatch);
+    k_run_add_workq(&sWorkSrc, 1, 4);
+    k_run();
 }
@@ -15,6 +15,7 @@ extern "C" {
 #endif
 
 #include "k_kernel.h"
+#include "k_run.h"
 
 typedef struct AppEvent AppEvent_t;
 typedef void (*AppEventHandler_t) (const AppEvent_t* event);
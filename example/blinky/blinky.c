@@ -9,6 +9,7 @@
  */
 #include "k_hsm.h"
 #include "k_kernel.h"
+#include "k_run.h"
 
 enum BlinkySignals {
     DUMMY_SIG = K_USER_SIG,
@@ -119,10 +120,7 @@ void Blinky_test(void) {
     k_msgq_init(&me->active.eQueue, (char *)blinkyEvtQueue, sizeof(k_mevt_t *), 10);
     me->active.super.init(&me->active.super, NULL);
 
-    while (true) {
-        k_mevt_t const *event = k_mevt_get(&me->active);
-        if (event) {
-            me->active.super.dispatch(&me->active.super, event);
-        }
-    }
+    static k_run_src_t sBlinkySrc;
+    k_run_add_hsm(&sBlinkySrc, 0, 4, &me->active);
+    k_run();
 }
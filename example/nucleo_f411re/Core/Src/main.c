@@ -76,6 +76,42 @@ void k_print(int level, const char *fmt, ...) {
     return;
 }
 
+#ifdef K_CONFIG_LOG_DEFERRED
+/* Deferred log backend: lines are queued here and sent by the TXE interrupt */
+RING_BUF_DECLARE(sLogTx, 512);
+
+static void LogUartWrite(const struct k_log_backend *backend, const char *data, size_t len) {
+	atomic_t key = k_interrupt_disable();
+
+#ifdef K_CONFIG_LOG_DICTIONARY
+	/* binary records for tools/k_log_decode.py, sent as they are */
+	ring_buf_put(&sLogTx, (const uint8_t *)data, len);
+#else
+	/* a line that does not fit is cut, the terminal gets CRLF */
+	ring_buf_put(&sLogTx, (const uint8_t *)data, len - 1);
+	ring_buf_put(&sLogTx, (const uint8_t *)"\r\n", 2);
+#endif
+	k_interrupt_enable(key);
+	LL_USART_EnableIT_TXE(USART2);
+}
+
+static struct k_log_backend sLogUart = {
+	.write = LogUartWrite,
+};
+
+void USART2_IRQHandler(void) {
+	uint8_t c;
+
+	if (LL_USART_IsEnabledIT_TXE(USART2) && LL_USART_IsActiveFlag_TXE(USART2)) {
+		if (ring_buf_get(&sLogTx, &c, 1) == 1) {
+			LL_USART_TransmitData8(USART2, c);
+		} else {
+			LL_USART_DisableIT_TXE(USART2);
+		}
+	}
+}
+#endif
+
 /* USER CODE END PFP */
 
 /* Private user code ---------------------------------------------------------*/
@@ -118,6 +154,12 @@ int main(void)
 	LL_TIM_ClearFlag_UPDATE(TIM11);
 	LL_TIM_EnableIT_UPDATE(TIM11);
 	LL_TIM_EnableCounter(TIM11);
+
+#ifdef K_CONFIG_LOG_DEFERRED
+	NVIC_SetPriority(USART2_IRQn, NVIC_EncodePriority(NVIC_GetPriorityGrouping(), 3, 0));
+	NVIC_EnableIRQ(USART2_IRQn);
+	k_log_backend_add(&sLogUart);
+#endif
 	
 //	app_event_test();
 	Blinky_test();
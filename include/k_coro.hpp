@@ -0,0 +1,295 @@
+/*
+ * @Date: 2026-10-19 20:12:37
+ * @FilePath: \Openy_Framework\include\k_coro.hpp
+ * @Description: C++20 coroutine adapter over k_timeout, k_work and k_msgq
+ *
+ * Coroutines are resumed from k_work_user_wait() on the core they suspended
+ * on, so they run in the main loop like any other work item and need no
+ * stack of their own. The resume work item lives in the awaiter and is
+ * submitted with k_work_user_submit_noalloc_to_cpu(), so a wake-up from an
+ * ISR cannot be lost to an exhausted queue node pool. Frames are
+ * taken from a fixed pool of K_CONFIG_CORO_FRAME_COUNT blocks, each
+ * K_CONFIG_CORO_FRAME_SIZE bytes, never from K_MALLOC.
+ *
+ * @code
+ * K_CORO_MSGQ_DEFINE(sSampleQ, uint32_t, 8);
+ *
+ * k::task sampler(void) {
+ *     for (;;) {
+ *         uint32_t v = co_await sSampleQ.get();
+ *         co_await k::sleep(K_MSEC(10));
+ *     }
+ * }
+ * @endcode
+ */
+#ifndef __K_CORO_HPP
+#define __K_CORO_HPP
+
+#if !defined(__cplusplus) || (__cplusplus < 202002L)
+#error "k_coro.hpp requires C++20"
+#endif
+
+#include <coroutine>
+#include <cstddef>
+
+#include "k_kernel.h"
+
+#if !defined(K_CONFIG_WORKQ) || !defined(K_CONFIG_MSGQ)
+#error "k_coro.hpp requires K_CONFIG_WORKQ and K_CONFIG_MSGQ"
+#endif
+
+#ifndef K_CONFIG_CORO_FRAME_SIZE
+#define K_CONFIG_CORO_FRAME_SIZE 256
+#endif
+
+#ifndef K_CONFIG_CORO_FRAME_COUNT
+#define K_CONFIG_CORO_FRAME_COUNT 4
+#endif
+
+namespace k {
+
+namespace detail {
+
+/* Fixed pool of coroutine frames, free blocks are chained through their
+ * first word. Frames are taken and returned from any core.
+ */
+class frame_pool {
+  public:
+    static void *alloc(std::size_t size) noexcept {
+        if (size > K_CONFIG_CORO_FRAME_SIZE) {
+            return nullptr;
+        }
+
+        k_spinlock_key_t key = k_spin_lock(&sLock);
+        init();
+        block *b = sFree;
+        if (b != nullptr) {
+            sFree = b->next;
+        }
+        k_spin_unlock(&sLock, key);
+        return b;
+    }
+
+    static void free(void *ptr) noexcept {
+        block *b = static_cast<block *>(ptr);
+
+        k_spinlock_key_t key = k_spin_lock(&sLock);
+        b->next = sFree;
+        sFree = b;
+        k_spin_unlock(&sLock, key);
+    }
+
+  private:
+    union block {
+        block *next;
+        alignas(std::max_align_t) unsigned char data[K_CONFIG_CORO_FRAME_SIZE];
+    };
+
+    /* called with sLock held */
+    static void init(void) noexcept {
+        if (!sInited) {
+            for (std::size_t i = 0; i < K_CONFIG_CORO_FRAME_COUNT; i++) {
+                sPool[i].next = sFree;
+                sFree = &sPool[i];
+            }
+            sInited = true;
+        }
+    }
+
+    static inline block sPool[K_CONFIG_CORO_FRAME_COUNT];
+    static inline block *sFree = nullptr;
+    static inline bool sInited = false;
+    static inline struct k_spinlock sLock = {0};
+};
+
+/* Work handler shared by every awaiter: work->context holds the address of
+ * the suspended coroutine.
+ */
+inline void resume_handler(k_work_user_t *work) {
+    std::coroutine_handle<>::from_address(work->context).resume();
+}
+
+/* Resume work item embedded in an awaiter, bound to the suspending core */
+struct resume_work {
+    k_work_user_t work;
+    int cpu;
+
+    void arm(std::coroutine_handle<> h) noexcept {
+        work.handler = resume_handler;
+        work.context = h.address();
+        work.flags = 0;
+        cpu = k_cpu_id();
+    }
+
+    /* cannot fail: the item is linked in place and is never pending while
+     * its coroutine is suspended
+     */
+    void submit(void) noexcept { (void)k_work_user_submit_noalloc_to_cpu(cpu, &work); }
+};
+
+} // namespace detail
+
+/**
+ * @brief Fire-and-forget coroutine.
+ *
+ * The body runs immediately up to its first suspension point, afterwards it
+ * is driven by k_work_user_wait(). The frame goes back to the pool when the
+ * body returns. If the pool is exhausted the coroutine does not run and
+ * valid() returns false.
+ */
+class task {
+  public:
+    struct promise_type {
+        static void *operator new(std::size_t size) noexcept { return detail::frame_pool::alloc(size); }
+        static void operator delete(void *ptr) noexcept { detail::frame_pool::free(ptr); }
+
+        static task get_return_object_on_allocation_failure() noexcept { return task(false); }
+        task get_return_object() noexcept { return task(true); }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { __ASSERT_NO_MSG(false); }
+    };
+
+    bool valid(void) const { return mValid; }
+
+  private:
+    explicit task(bool valid) : mValid(valid) {}
+    bool mValid;
+};
+
+/**
+ * @brief Awaitable returned by k::sleep().
+ *
+ * The timeout fires in the timer ISR and only submits a work item, the
+ * coroutine itself resumes in the main loop.
+ */
+class sleep_awaiter {
+  public:
+    explicit sleep_awaiter(k_timeout_t timeout) : mTimeout(timeout) {
+        sys_dnode_init(&mNode.timeout.node);
+    }
+
+    bool await_ready(void) const noexcept { return K_TIMEOUT_EQ(mTimeout, K_NO_WAIT); }
+
+    void await_suspend(std::coroutine_handle<> h) noexcept {
+        mNode.resume.arm(h);
+        k_timeout_add(&mNode.timeout, timeout_handler, mTimeout);
+    }
+
+    void await_resume(void) const noexcept {}
+
+  private:
+    struct node {
+        struct _timeout timeout;
+        detail::resume_work resume;
+    };
+
+    static void timeout_handler(struct _timeout *to) {
+        node *n = CONTAINER_OF(to, node, timeout);
+        n->resume.submit();
+    }
+
+    k_timeout_t mTimeout;
+    node mNode;
+};
+
+/**
+ * @brief Suspend the calling coroutine for @a timeout.
+ *
+ * @code co_await k::sleep(K_MSEC(10)); @endcode
+ */
+inline sleep_awaiter sleep(k_timeout_t timeout) { return sleep_awaiter(timeout); }
+
+/**
+ * @brief Message queue with an awaitable get().
+ *
+ * The underlying k_msgq is exposed through c_msgq(), so C producers and ISRs
+ * keep using k_msgq_put(). A single coroutine may wait on the queue at a
+ * time.
+ */
+template <typename T, uint32_t N> class msgq {
+  public:
+    class get_awaiter {
+      public:
+        explicit get_awaiter(msgq &q) : mQueue(q) {}
+
+        bool await_ready(void) noexcept { return k_msgq_get(&mQueue.mMsgq, &mValue) == 0; }
+
+        bool await_suspend(std::coroutine_handle<> h) noexcept {
+            bool suspend;
+
+            mResume.arm(h);
+
+            /* re-check under the lock, a put may have slipped in after await_ready() */
+            k_spinlock_key_t key = k_spin_lock(&mQueue.mLock);
+            __ASSERT(mQueue.mWaiter == nullptr, "only one waiter per msgq");
+            suspend = k_msgq_get(&mQueue.mMsgq, &mValue) != 0;
+            if (suspend) {
+                mQueue.mWaiter = this;
+            }
+            k_spin_unlock(&mQueue.mLock, key);
+            return suspend;
+        }
+
+        T await_resume(void) noexcept { return mValue; }
+
+      private:
+        friend class msgq;
+
+        msgq &mQueue;
+        detail::resume_work mResume;
+        T mValue;
+    };
+
+    msgq(void) {
+        k_msgq_init(&mMsgq, reinterpret_cast<char *>(mBuffer), sizeof(T), N);
+        k_msgq_set_notify(&mMsgq, notify, this);
+    }
+
+    msgq(const msgq &) = delete;
+    msgq &operator=(const msgq &) = delete;
+
+    int put(const T &msg) { return k_msgq_put(&mMsgq, &msg); }
+    get_awaiter get(void) { return get_awaiter(*this); }
+    k_msgq_t *c_msgq(void) { return &mMsgq; }
+
+  private:
+    /* Runs right after a successful k_msgq_put(), possibly in an ISR. The
+     * message is taken here so that no other consumer can steal it before
+     * the coroutine resumes, the allocation-free resume keeps it from being
+     * lost.
+     */
+    static void notify(k_msgq_t *q, void *user_data) {
+        msgq *self = static_cast<msgq *>(user_data);
+
+        k_spinlock_key_t key = k_spin_lock(&self->mLock);
+        get_awaiter *w = self->mWaiter;
+        if (w != nullptr && k_msgq_get(q, &w->mValue) == 0) {
+            self->mWaiter = nullptr;
+        } else {
+            w = nullptr;
+        }
+        k_spin_unlock(&self->mLock, key);
+
+        if (w != nullptr) {
+            w->mResume.submit();
+        }
+    }
+
+    k_msgq_t mMsgq;
+    /* Guards the mWaiter hand-off between the awaiter and producers on any core */
+    struct k_spinlock mLock = {0};
+    get_awaiter *mWaiter = nullptr;
+    alignas(T) unsigned char mBuffer[N * sizeof(T)];
+};
+
+} // namespace k
+
+/**
+ * @brief Statically define a coroutine-aware message queue of @a q_max_msgs
+ * elements of @a q_type.
+ */
+#define K_CORO_MSGQ_DEFINE(q_name, q_type, q_max_msgs) static k::msgq<q_type, q_max_msgs> q_name
+
+#endif // __K_CORO_HPP
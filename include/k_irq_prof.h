@@ -0,0 +1,50 @@
+/*
+ * @Date: 2026-10-20 17:02:37
+ * @FilePath: \Openy_Framework\include\k_irq_prof.h
+ * @Description: Critical section duration profiler
+ *
+ * Enabled with K_CONFIG_IRQ_PROFILE. k_interrupt_disable()/enable() then
+ * become macros capturing the caller's file and line, and every outermost
+ * masked region is timed with k_cycle_get_32() and charged to the site that
+ * opened it. When disabled nothing here is compiled and the primitives are
+ * called directly.
+ */
+#ifndef __K_IRQ_PROF_H
+#define __K_IRQ_PROF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "k_config.h"
+
+#ifdef K_CONFIG_IRQ_PROFILE
+
+/* call sites tracked individually, further sites share the last entry */
+#ifndef K_CONFIG_IRQ_PROFILE_SITES
+#define K_CONFIG_IRQ_PROFILE_SITES 32
+#endif
+
+struct k_irq_prof_site {
+    /** NULL for an unused entry, "other" for the overflow entry */
+    const char *file;
+    int line;
+    uint32_t count;
+    /** Masked time in cycles, summed and worst case */
+    uint64_t total_cycles;
+    uint32_t max_cycles;
+};
+
+int k_irq_prof_site_get(int index, struct k_irq_prof_site *site);
+void k_irq_prof_reset(void);
+void k_irq_prof_dump(void);
+
+#endif // K_CONFIG_IRQ_PROFILE
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __K_IRQ_PROF_H
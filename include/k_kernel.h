@@ -27,6 +27,10 @@ extern "C" {
 #include "k_timeout.h"
 
 #include "k_config.h"
+#include "k_stats.h"
+#include "k_irq_prof.h"
+#include "k_trace.h"
+#include "k_load.h"
 
 #ifdef K_CONFIG_RINGBUFFER
 #include "k_ring_buffer.h"
@@ -37,24 +41,301 @@ void sys_clock_isr(void);
 void sys_clock_set_timeout(int32_t ticks, bool idle);
 uint32_t sys_clock_elapsed(void);
 void k_msleep(int32_t ms);
+/* free running cpu cycle counter, wraps */
+uint32_t k_cycle_get_32(void);
+uint32_t k_cycle_hz(void);
 
-/* atomic operation, user implement */
+/* atomic operation, user implement. All of them are full barriers and
+ * return the previous value where they return an atomic_t.
+ */
 typedef long atomic_t;
+typedef void *atomic_ptr_t;
 bool atomic_test_and_set_bit(atomic_t *target, int bit);
 bool atomic_test_and_clear_bit(atomic_t *target, int bit);
 void atomic_clear_bit(atomic_t *target, int bit);
+void atomic_set_bit(atomic_t *target, int bit);
+void atomic_set_bit_to(atomic_t *target, int bit, bool val);
+bool atomic_test_bit(const atomic_t *target, int bit);
+atomic_t atomic_get(const atomic_t *target);
+atomic_t atomic_set(atomic_t *target, atomic_t value);
+atomic_t atomic_clear(atomic_t *target);
+bool atomic_cas(atomic_t *target, atomic_t old_value, atomic_t new_value);
+atomic_t atomic_add(atomic_t *target, atomic_t value);
+atomic_t atomic_sub(atomic_t *target, atomic_t value);
+atomic_t atomic_inc(atomic_t *target);
+atomic_t atomic_dec(atomic_t *target);
+atomic_t atomic_or(atomic_t *target, atomic_t value);
+atomic_t atomic_and(atomic_t *target, atomic_t value);
+atomic_t atomic_xor(atomic_t *target, atomic_t value);
+atomic_t atomic_nand(atomic_t *target, atomic_t value);
+void *atomic_ptr_get(const atomic_ptr_t *target);
+void *atomic_ptr_set(atomic_ptr_t *target, void *value);
+void *atomic_ptr_clear(atomic_ptr_t *target);
+bool atomic_ptr_cas(atomic_ptr_t *target, void *old_value, void *new_value);
 atomic_t k_interrupt_disable(void);
 void k_interrupt_enable(atomic_t key);
+void k_cpu_atomic_idle(atomic_t key);
+
+#ifdef K_CONFIG_IRQ_PROFILE
+/* time masked regions per call site (k_irq_prof.h), the port and the
+ * profiler itself #undef these to reach the primitives
+ */
+atomic_t z_irq_prof_disable(const char *file, int line);
+void z_irq_prof_enable(atomic_t key);
+void z_irq_prof_stop(atomic_t key);
+#define k_interrupt_disable()   z_irq_prof_disable(__FILE__, __LINE__)
+#define k_interrupt_enable(key) z_irq_prof_enable(key)
+#endif // K_CONFIG_IRQ_PROFILE
+
+#ifdef K_CONFIG_SMP
+#define Z_NUM_CPUS K_CONFIG_MP_MAX_NUM_CPUS
+/* index of the calling core, 0 .. K_CONFIG_MP_MAX_NUM_CPUS - 1, user implement */
+int k_cpu_id(void);
+#else
+#define Z_NUM_CPUS 1
+static inline int k_cpu_id(void) { return 0; }
+#endif // K_CONFIG_SMP
+
+/*
+ * Spinlock: masks interrupts like k_interrupt_disable(), and with K_CONFIG_SMP
+ * also spins on the lock word so other cores are kept out of the object. On
+ * a single core the word is never touched. Locks of different objects are
+ * independent, nest them in a fixed order.
+ */
+struct k_spinlock {
+    atomic_t locked;
+};
+
+typedef atomic_t k_spinlock_key_t;
+
+static inline k_spinlock_key_t z_spin_lock(struct k_spinlock *l, k_spinlock_key_t key) {
+#ifdef K_CONFIG_SMP
+    while (!atomic_cas(&l->locked, 0, 1)) {
+        while (atomic_get(&l->locked) != 0) {
+        }
+    }
+#else
+    ARG_UNUSED(l);
+#endif
+    return key;
+}
+
+/**
+ * @brief Take a spinlock.
+ *
+ * A macro so that the interrupt mask is taken at the caller's line, which is
+ * what K_CONFIG_IRQ_PROFILE reports.
+ *
+ * @funcprops \isr_ok
+ *
+ * @param l Address of the lock.
+ *
+ * @return Key to pass to k_spin_unlock().
+ */
+#define k_spin_lock(l) z_spin_lock((l), k_interrupt_disable())
+
+/**
+ * @brief Release a spinlock taken by k_spin_lock().
+ *
+ * @param l Address of the lock.
+ * @param key Value returned by k_spin_lock().
+ */
+static inline void k_spin_unlock(struct k_spinlock *l, k_spinlock_key_t key) {
+#ifdef K_CONFIG_SMP
+    (void)atomic_clear(&l->locked);
+#else
+    ARG_UNUSED(l);
+#endif
+    k_interrupt_enable(key);
+}
+
+#ifdef K_CONFIG_LIFO
+
+/**
+ * @brief Statically define and initialize a lock-free LIFO.
+ *
+ * @param name Name of the LIFO.
+ * @param region Start of the memory all nodes are taken from, e.g. a pool.
+ * @param region_size Size of @a region (in bytes), see k_lifo_init().
+ */
+#define K_LIFO_DEFINE(name, region, region_size)                                                   \
+    static k_lifo_t name = {                                                                       \
+        .head = 0,                                                                                 \
+        .base = (char *)(region),                                                                  \
+        .max_idx = (region_size) / (sizeof(void *)),                                               \
+    }
+
+typedef struct k_lifo k_lifo_t;
+
+struct k_lifo {
+    /** Tagged top of stack: modification count in the upper half, node
+     * index + 1 in the lower half (0 when empty)
+     */
+    atomic_t head;
+    /** Nodes live in [base, base + max_idx * sizeof(void *)) */
+    char *base;
+    uint32_t max_idx;
+};
+
+int k_lifo_init(k_lifo_t *lifo, void *region, size_t region_size);
+void k_lifo_push(k_lifo_t *lifo, void *node);
+void *k_lifo_pop(k_lifo_t *lifo);
+bool k_lifo_is_empty(k_lifo_t *lifo);
+
+#endif // K_CONFIG_LIFO
+
+#ifdef K_CONFIG_MEM_SLAB
+
+#ifndef K_CONFIG_LIFO
+#error "K_CONFIG_MEM_SLAB requires K_CONFIG_LIFO"
+#endif
+
+/**
+ * @brief Statically define and initialize a memory slab.
+ *
+ * The slab is usable without calling k_mem_slab_init(): blocks are carved
+ * from the buffer on first use, so no boot-time pass over the buffer is
+ * needed.
+ *
+ * @param name Name of the memory slab.
+ * @param slab_block_size Size of each block (in bytes), a multiple of
+ *        @a slab_align and at least the size of a pointer.
+ * @param slab_num_blocks Number of blocks, the buffer must fit a k_lifo
+ *        region (under 256 KB on a 32-bit target).
+ * @param slab_align Alignment of the buffer (power of 2).
+ */
+#define K_MEM_SLAB_DEFINE(name, slab_block_size, slab_num_blocks, slab_align)                     \
+    typedef char _k_mem_slab_chk_##name[((slab_block_size) % (slab_align) == 0U &&                \
+                                         (slab_block_size) >= sizeof(void *) &&                    \
+                                         (slab_num_blocks) * (slab_block_size) /                   \
+                                                 (sizeof(void *)) <                                \
+                                             (1UL << (sizeof(atomic_t) * 4U)) - 1UL)               \
+                                            ? 1                                                    \
+                                            : -1];                                                 \
+    static char __attribute__((__aligned__(slab_align)))                                           \
+    _k_mem_slab_buf_##name[(slab_num_blocks) * (slab_block_size)];                                 \
+    static k_mem_slab_t name = {                                                                   \
+        .buffer = _k_mem_slab_buf_##name,                                                          \
+        .block_size = slab_block_size,                                                             \
+        .num_blocks = slab_num_blocks,                                                             \
+        .free_list = {.head = 0,                                                                   \
+                      .base = _k_mem_slab_buf_##name,                                              \
+                      .max_idx = (slab_num_blocks) * (slab_block_size) / (sizeof(void *))},        \
+        .fresh = 0,                                                                                \
+        .num_used = 0,                                                                             \
+        .max_used = 0,                                                                             \
+    }
+
+typedef struct k_mem_slab k_mem_slab_t;
+
+struct k_mem_slab {
+    /** Block storage */
+    char *buffer;
+    size_t block_size;
+    uint32_t num_blocks;
+    /** Freed blocks */
+    k_lifo_t free_list;
+    /** Blocks [fresh, num_blocks) have never been handed out */
+    atomic_t fresh;
+    atomic_t num_used;
+    /** Peak of num_used */
+    atomic_t max_used;
+};
+
+int k_mem_slab_init(k_mem_slab_t *slab, void *buffer, size_t block_size, uint32_t num_blocks);
+int k_mem_slab_alloc(k_mem_slab_t *slab, void **mem);
+void k_mem_slab_free(k_mem_slab_t *slab, void *mem);
+uint32_t k_mem_slab_num_used_get(k_mem_slab_t *slab);
+uint32_t k_mem_slab_num_free_get(k_mem_slab_t *slab);
+uint32_t k_mem_slab_max_used_get(k_mem_slab_t *slab);
+void k_mem_slab_runtime_stats_reset_max(k_mem_slab_t *slab);
+
+#endif // K_CONFIG_MEM_SLAB
+
+#ifdef K_CONFIG_HEAP
+
+#ifndef K_CONFIG_HEAP_FL_INDEX_MAX
+#define K_CONFIG_HEAP_FL_INDEX_MAX 20
+#endif
+
+/* TLSF geometry: 16 second-level lists per power of two, blocks aligned on
+ * a pointer, first level covers sizes up to 2^K_CONFIG_HEAP_FL_INDEX_MAX
+ */
+#define K_HEAP_SL_INDEX_COUNT_LOG2 4
+#define K_HEAP_SL_INDEX_COUNT      (1 << K_HEAP_SL_INDEX_COUNT_LOG2)
+#if UINTPTR_MAX > 0xFFFFFFFFU
+#define K_HEAP_ALIGN_SIZE_LOG2 3
+#else
+#define K_HEAP_ALIGN_SIZE_LOG2 2
+#endif
+#define K_HEAP_ALIGN_SIZE      (1 << K_HEAP_ALIGN_SIZE_LOG2)
+#define K_HEAP_FL_INDEX_SHIFT  (K_HEAP_SL_INDEX_COUNT_LOG2 + K_HEAP_ALIGN_SIZE_LOG2)
+#define K_HEAP_FL_INDEX_COUNT  (K_CONFIG_HEAP_FL_INDEX_MAX - K_HEAP_FL_INDEX_SHIFT + 1)
+
+/**
+ * @brief Statically define a heap.
+ *
+ * The heap is set up on its first allocation, k_heap_init() is not needed.
+ *
+ * @param name Name of the heap.
+ * @param bytes Size of the heap memory (in bytes).
+ */
+#define K_HEAP_DEFINE(name, bytes)                                                                 \
+    static char __attribute__((__aligned__(K_HEAP_ALIGN_SIZE))) _k_heap_mem_##name[bytes];        \
+    static k_heap_t name = {.mem = _k_heap_mem_##name, .mem_size = (bytes)}
+
+typedef struct k_heap k_heap_t;
+
+struct k_heap {
+    /** Backing memory, kept for the lazy setup of K_HEAP_DEFINE heaps */
+    void *mem;
+    size_t mem_size;
+    bool ready;
+    /** Bit n set if first-level list n has free blocks */
+    uint32_t fl_bitmap;
+    uint32_t sl_bitmap[K_HEAP_FL_INDEX_COUNT];
+    struct z_heap_block *blocks[K_HEAP_FL_INDEX_COUNT][K_HEAP_SL_INDEX_COUNT];
+    size_t allocated_bytes;
+    size_t max_allocated_bytes;
+    uint32_t alloc_fails;
+    struct k_spinlock lock;
+};
+
+struct k_heap_stats {
+    /** Sum of free block sizes */
+    size_t free_bytes;
+    /** Sum of allocated block sizes, including rounding */
+    size_t allocated_bytes;
+    size_t max_allocated_bytes;
+    /** Largest allocation that can currently succeed */
+    size_t largest_free;
+    uint32_t free_blocks;
+    uint32_t alloc_fails;
+    /** 100 * (1 - largest_free / free_bytes), in percent */
+    uint8_t fragmentation;
+};
+
+int k_heap_init(k_heap_t *heap, void *mem, size_t bytes);
+void *k_heap_alloc(k_heap_t *heap, size_t bytes);
+void k_heap_free(k_heap_t *heap, void *mem);
+void k_heap_stats_get(k_heap_t *heap, struct k_heap_stats *stats);
+void k_heap_runtime_stats_reset_max(k_heap_t *heap);
+
+#endif // K_CONFIG_HEAP
+
 
 #ifdef K_CONFIG_QUEUE
 
 #define K_QUEUE_INITIALIZER(obj) \
-    { .data_q = SYS_SFLIST_STATIC_INIT(&obj.data_q), .lock = 0 }
+    { .data_q = SYS_SFLIST_STATIC_INIT(&obj.data_q), .lock = {0} }
 
 typedef struct k_queue k_queue_t;
 struct k_queue {
     sys_sflist_t data_q;
-    atomic_t lock;
+    struct k_spinlock lock;
+#ifdef K_CONFIG_OBJ_STATS
+    struct k_obj_stats stats;
+#endif
 };
 
 void *z_queue_node_peek(sys_sfnode_t *node, bool needs_free);
@@ -65,12 +346,41 @@ void k_queue_append(k_queue_t *queue, void *data);
 int32_t k_queue_alloc_append(k_queue_t *queue, void *data);
 void k_queue_prepend(k_queue_t *queue, void *data);
 int32_t k_queue_alloc_prepend(k_queue_t *queue, void *data);
+int k_queue_append_list(k_queue_t *queue, void *head, void *tail);
 void *k_queue_get(k_queue_t *queue);
+bool k_queue_get_all(k_queue_t *queue, sys_sflist_t *list);
+void *k_queue_list_get(sys_sflist_t *list);
 bool k_queue_remove(k_queue_t *queue, void *data);
 int k_queue_is_empty(k_queue_t *queue);
 void *k_queue_peek_head(k_queue_t *queue);
 void *k_queue_peek_tail(k_queue_t *queue);
 
+/*
+ * Doubly-linked queue: the first two words of each item are reserved for a
+ * sys_dnode_t, which makes k_dqueue_remove() O(1) whatever the depth.
+ */
+#define K_DQUEUE_INITIALIZER(obj) \
+    { .data_q = SYS_DLIST_STATIC_INIT(&obj.data_q), .lock = {0} }
+
+typedef struct k_dqueue k_dqueue_t;
+struct k_dqueue {
+    sys_dlist_t data_q;
+    struct k_spinlock lock;
+#ifdef K_CONFIG_OBJ_STATS
+    struct k_obj_stats stats;
+#endif
+};
+
+void k_dqueue_init(k_dqueue_t *queue);
+void k_dqueue_insert(k_dqueue_t *queue, void *prev, void *data);
+void k_dqueue_append(k_dqueue_t *queue, void *data);
+void k_dqueue_prepend(k_dqueue_t *queue, void *data);
+void *k_dqueue_get(k_dqueue_t *queue);
+bool k_dqueue_remove(k_dqueue_t *queue, void *data);
+int k_dqueue_is_empty(k_dqueue_t *queue);
+void *k_dqueue_peek_head(k_dqueue_t *queue);
+void *k_dqueue_peek_tail(k_dqueue_t *queue);
+
 #endif // K_CONFIG_QUEUE
 
 #ifdef K_CONFIG_TIMER
@@ -119,6 +429,7 @@ k_timer_t *k_timer_create(k_timer_expiry_t expiry_fn, void *user_data);
 void k_timer_init(k_timer_t *timer, k_timer_expiry_t expiry_fn, void *user_data);
 void k_timer_start(k_timer_t *timer, k_timeout_t duration, k_timeout_t period);
 void k_timer_stop(k_timer_t *timer);
+void k_timer_delete(k_timer_t *timer);
 
 #endif // K_CONFIG_TIMER
 
@@ -158,10 +469,18 @@ void k_timer_stop(k_timer_t *timer);
 	    .read_ptr = q_buffer, \
 	    .write_ptr = q_buffer, \
 	    .used_msgs = 0, \
-        .lock = 0, \
+        .lock = {0}, \
+        .notify = NULL, \
+        .notify_data = NULL, \
+        .flags = 0, \
+        .dropped_msgs = 0, \
 	}
 
 typedef struct k_msgq k_msgq_t;
+typedef void (*k_msgq_notify_t)(k_msgq_t *msgq, void *user_data);
+
+/** A put on a full queue drops the oldest message instead of failing */
+#define K_MSGQ_FLAG_OVERWRITE BIT(0)
 
 struct k_msgq {
     /** Message size */
@@ -178,21 +497,256 @@ struct k_msgq {
     char *write_ptr;
     /** Number of used messages */
     uint32_t used_msgs;
-    atomic_t lock;
+    struct k_spinlock lock;
+    /** Called after a successful put, may run in ISR context */
+    k_msgq_notify_t notify;
+    void *notify_data;
+    /** K_MSGQ_FLAG_* */
+    uint32_t flags;
+    /** Messages discarded in overwrite mode */
+    uint32_t dropped_msgs;
+#ifdef K_CONFIG_OBJ_STATS
+    struct k_obj_stats stats;
+#endif
 };
 
 void k_msgq_init(k_msgq_t *msgq, char *buffer, size_t msg_size, uint32_t max_msgs);
 int k_msgq_put(k_msgq_t *msgq, const void *data);
 int k_msgq_get(k_msgq_t *msgq, void *data);
+uint32_t k_msgq_put_n(k_msgq_t *msgq, const void *data, uint32_t n);
+uint32_t k_msgq_get_n(k_msgq_t *msgq, void *data, uint32_t n);
 void k_msgq_purge(k_msgq_t *msgq);
 int k_msgq_peek(struct k_msgq *msgq, void *data);
+void k_msgq_set_notify(k_msgq_t *msgq, k_msgq_notify_t notify, void *user_data);
+void k_msgq_set_overwrite(k_msgq_t *msgq, bool enable);
+uint32_t k_msgq_dropped_get(k_msgq_t *msgq);
+
+/**
+ * @brief Statically define and initialize a single-producer/single-consumer
+ * message queue.
+ *
+ * Same parameters as @ref K_MSGQ_DEFINE. Put and get never mask interrupts,
+ * so the producer may be a high rate ISR. With a power-of-two
+ * @a q_max_msgs the index wrap is a mask instead of a compare.
+ */
+#define K_MSGQ_SPSC_DEFINE(q_name, q_msg_size, q_max_msgs, q_align) \
+    static char __attribute__((__aligned__(q_align)))              \
+    _k_spsc_buf_##q_name[(q_max_msgs) * (q_msg_size)];             \
+    static k_msgq_spsc_t q_name =                                  \
+        K_MSGQ_SPSC_INITIALIZER(_k_spsc_buf_##q_name, (q_msg_size), (q_max_msgs))
+
+#define K_MSGQ_SPSC_IS_POW2(n) (((n) > 1U) && (((n) & ((n) - 1U)) == 0U))
+
+#define K_MSGQ_SPSC_INITIALIZER(q_buffer, q_msg_size, q_max_msgs) \
+    { \
+        .msg_size = q_msg_size, \
+        .max_msgs = q_max_msgs, \
+        .mask = K_MSGQ_SPSC_IS_POW2(q_max_msgs) ? ((q_max_msgs) - 1U) : 0U, \
+        .buffer = q_buffer, \
+        .head = 0, \
+        .tail = 0, \
+    }
+
+typedef struct k_msgq_spsc k_msgq_spsc_t;
+
+struct k_msgq_spsc {
+    /** Message size */
+    size_t msg_size;
+    /** Maximal number of messages */
+    uint32_t max_msgs;
+    /** max_msgs - 1 if max_msgs is a power of two, 0 otherwise */
+    uint32_t mask;
+    /** Message buffer */
+    char *buffer;
+    /** Write index, only modified by the producer */
+    atomic_t head;
+    /** Read index, only modified by the consumer */
+    atomic_t tail;
+};
+
+void k_msgq_spsc_init(k_msgq_spsc_t *msgq, char *buffer, size_t msg_size, uint32_t max_msgs);
+int k_msgq_spsc_put(k_msgq_spsc_t *msgq, const void *data);
+int k_msgq_spsc_get(k_msgq_spsc_t *msgq, void *data);
+int k_msgq_spsc_peek(k_msgq_spsc_t *msgq, void *data);
+uint32_t k_msgq_spsc_num_used_get(k_msgq_spsc_t *msgq);
+
+#ifndef K_CONFIG_MSGQ_PRIO_BANDS
+#define K_CONFIG_MSGQ_PRIO_BANDS 4
+#endif
+
+/**
+ * @brief Statically define and initialize a priority-band message queue.
+ *
+ * K_CONFIG_MSGQ_PRIO_BANDS bands share a pool of @a q_max_msgs slots of
+ * @a q_msg_size bytes. Band 0 is the most urgent. Every band may use the
+ * whole pool until k_msgq_prio_set_limit() caps it.
+ *
+ * @param q_name Name of the message queue.
+ * @param q_msg_size Message size (in bytes).
+ * @param q_max_msgs Number of slots shared by all bands, below
+ *        K_MSGQ_PRIO_NONE.
+ * @param q_align Alignment of the message buffer.
+ */
+#define K_MSGQ_PRIO_DEFINE(q_name, q_msg_size, q_max_msgs, q_align)                               \
+    typedef char _k_msgq_prio_chk_##q_name[((q_max_msgs) < K_MSGQ_PRIO_NONE) ? 1 : -1];            \
+    static char __attribute__((__aligned__(q_align)))                                              \
+    _k_prio_buf_##q_name[(q_max_msgs) * (q_msg_size)];                                             \
+    static uint16_t _k_prio_next_##q_name[q_max_msgs];                                             \
+    static k_msgq_prio_t q_name = {                                                                \
+        .msg_size = q_msg_size,                                                                    \
+        .max_msgs = q_max_msgs,                                                                    \
+        .buffer = _k_prio_buf_##q_name,                                                            \
+        .next = _k_prio_next_##q_name,                                                             \
+        .free_head = K_MSGQ_PRIO_NONE,                                                             \
+        .fresh = 0,                                                                                \
+        .ready = 0,                                                                                \
+        .lock = {0},                                                                               \
+    }
+
+/* slot index meaning "no slot", so a queue holds at most 0xFFFE slots */
+#define K_MSGQ_PRIO_NONE 0xFFFFU
+
+typedef struct k_msgq_prio k_msgq_prio_t;
+
+struct k_msgq_prio {
+    /** Message size */
+    size_t msg_size;
+    /** Number of slots in the shared pool */
+    uint16_t max_msgs;
+    /** Slot storage */
+    char *buffer;
+    /** Per-slot link, used by both the band FIFOs and the free list */
+    uint16_t *next;
+    /** Free list of recycled slots */
+    uint16_t free_head;
+    /** Slots [fresh, max_msgs) have never been used */
+    uint16_t fresh;
+    uint16_t head[K_CONFIG_MSGQ_PRIO_BANDS];
+    uint16_t tail[K_CONFIG_MSGQ_PRIO_BANDS];
+    uint16_t used[K_CONFIG_MSGQ_PRIO_BANDS];
+    /** Per-band depth limit, 0 means the whole pool */
+    uint16_t limit[K_CONFIG_MSGQ_PRIO_BANDS];
+    /** Bit n set if band n is not empty */
+    uint32_t ready;
+    struct k_spinlock lock;
+};
+
+int k_msgq_prio_init(k_msgq_prio_t *msgq, char *buffer, uint16_t *next, size_t msg_size,
+                      uint16_t max_msgs);
+int k_msgq_prio_set_limit(k_msgq_prio_t *msgq, uint8_t band, uint16_t limit);
+int k_msgq_prio_put(k_msgq_prio_t *msgq, uint8_t band, const void *data);
+int k_msgq_prio_get(k_msgq_prio_t *msgq, void *data, uint8_t *band);
+void k_msgq_prio_purge(k_msgq_prio_t *msgq);
+
+/**
+ * @brief Statically define a typed message queue.
+ *
+ * Emits a queue object @a q_name plus inline q_name_put(), q_name_get(),
+ * q_name_purge() and q_name_num_used_get(). Messages are copied by struct
+ * assignment and the depth and wrap mask are compile-time constants, so a
+ * put/get on a small type compiles to a few word moves instead of a memcpy
+ * call. Locking and return codes are the same as k_msgq_put()/k_msgq_get().
+ *
+ * @param q_name Name of the message queue.
+ * @param q_type Message type.
+ * @param q_max_msgs Maximum number of messages, must be a non-zero power of 2.
+ */
+#define K_MSGQ_TYPED_DEFINE(q_name, q_type, q_max_msgs)                                            \
+    typedef char _k_msgq_typed_pow2_##q_name                                                       \
+        [((q_max_msgs) > 0U && ((q_max_msgs) & ((q_max_msgs) - 1U)) == 0U) ? 1 : -1];              \
+    static struct {                                                                                \
+        q_type buffer[q_max_msgs];                                                                 \
+        uint32_t write_idx;                                                                        \
+        uint32_t read_idx;                                                                         \
+        struct k_spinlock lock;                                                                    \
+    } q_name = {.write_idx = 0, .read_idx = 0, .lock = {0}};                                       \
+    static inline int q_name##_put(const q_type *data) {                                           \
+        int result = -ENOMEM;                                                                      \
+        k_spinlock_key_t key = k_spin_lock(&q_name.lock);                                          \
+        if ((uint32_t)(q_name.write_idx - q_name.read_idx) < (q_max_msgs)) {                       \
+            q_name.buffer[q_name.write_idx & ((q_max_msgs) - 1U)] = *data;                         \
+            q_name.write_idx++;                                                                    \
+            result = 0;                                                                            \
+        }                                                                                          \
+        k_spin_unlock(&q_name.lock, key);                                                          \
+        return result;                                                                             \
+    }                                                                                              \
+    static inline int q_name##_get(q_type *data) {                                                 \
+        int result = -EINVAL;                                                                      \
+        k_spinlock_key_t key = k_spin_lock(&q_name.lock);                                          \
+        if (q_name.write_idx != q_name.read_idx) {                                                 \
+            *data = q_name.buffer[q_name.read_idx & ((q_max_msgs) - 1U)];                          \
+            q_name.read_idx++;                                                                     \
+            result = 0;                                                                            \
+        }                                                                                          \
+        k_spin_unlock(&q_name.lock, key);                                                          \
+        return result;                                                                             \
+    }                                                                                              \
+    static inline void q_name##_purge(void) {                                                      \
+        k_spinlock_key_t key = k_spin_lock(&q_name.lock);                                          \
+        q_name.read_idx = q_name.write_idx;                                                        \
+        k_spin_unlock(&q_name.lock, key);                                                          \
+    }                                                                                              \
+    static inline uint32_t q_name##_num_used_get(void) {                                           \
+        return (uint32_t)(q_name.write_idx - q_name.read_idx);                                     \
+    }
 
 #endif // K_CONFIG_MSGQ
 
+#if defined(K_CONFIG_VMSGQ) && defined(K_CONFIG_RINGBUFFER)
+
+/**
+ * @brief Statically define and initialize a variable-length message queue.
+ *
+ * Each message is stored as a 32-bit header (16-bit type, 16-bit byte
+ * length) followed by the payload padded to a 32-bit boundary, so a message
+ * costs its own size plus at most 7 bytes instead of a fixed slot.
+ *
+ * @param q_name Name of the message queue.
+ * @param q_size32 Size of the storage (in 32-bit words).
+ */
+#define K_VMSGQ_DEFINE(q_name, q_size32)                                                           \
+    typedef char _k_vmsgq_chk_##q_name[((q_size32) < RING_BUFFER_MAX_SIZE / 4) ? 1 : -1];          \
+    static uint32_t _k_vmsgq_buf_##q_name[q_size32];                                               \
+    static k_vmsgq_t q_name = {                                                                    \
+        .rb = {.buffer = (uint8_t *)_k_vmsgq_buf_##q_name, .size = 4 * (q_size32)},                \
+        .put_hdr = NULL,                                                                           \
+        .put_size = 0,                                                                             \
+        .get_size = 0,                                                                             \
+    }
+
+/** Largest payload of a single message (in bytes): the buffer holds at most
+ * RING_BUFFER_MAX_SIZE - 4 bytes and each record carries a 4-byte header
+ */
+#define K_VMSGQ_MSG_SIZE_MAX (RING_BUFFER_MAX_SIZE - 8U)
+
+typedef struct k_vmsgq k_vmsgq_t;
+
+struct k_vmsgq {
+    struct ring_buf rb;
+    /** Header of the record being claimed by the producer */
+    uint8_t *put_hdr;
+    /** Payload bytes claimed by the producer */
+    uint32_t put_size;
+    /** Record bytes claimed by the consumer */
+    uint32_t get_size;
+};
+
+void k_vmsgq_init(k_vmsgq_t *msgq, uint32_t *buffer, uint32_t size32);
+int k_vmsgq_put_claim(k_vmsgq_t *msgq, void **data, uint32_t size);
+int k_vmsgq_put_commit(k_vmsgq_t *msgq, uint16_t type, uint32_t size);
+int k_vmsgq_get_claim(k_vmsgq_t *msgq, uint16_t *type, void **data, uint32_t *size);
+int k_vmsgq_get_finish(k_vmsgq_t *msgq);
+int k_vmsgq_put(k_vmsgq_t *msgq, uint16_t type, const void *data, uint32_t size);
+int k_vmsgq_get(k_vmsgq_t *msgq, uint16_t *type, void *data, uint32_t *size);
+bool k_vmsgq_is_empty(k_vmsgq_t *msgq);
+
+#endif // K_CONFIG_VMSGQ
+
 #ifdef K_CONFIG_WORKQ
 
 #define K_WORK_USER_INITIALIZER(work_handler) \
-    { .handler = work_handler, .context = NULL, .flags = 0 }
+    { .handler = work_handler, .context = NULL, .flags = 0, .next = NULL }
 
 typedef struct k_work_user k_work_user_t;
 typedef struct k_work_delayable k_work_delayable_t;
@@ -204,16 +758,31 @@ struct k_work_user {
     k_work_user_handler_t handler;
     void *context;
     atomic_t flags;
+    /** Link in the inbox of a core */
+    k_work_user_t *next;
 };
 
 struct k_work_delayable {
     struct _timeout timeout;
     k_work_user_t work;
+#ifdef K_CONFIG_SMP
+    /** Core the work is submitted to when the delay expires */
+    uint8_t cpu;
+#endif
 };
 
+/*
+ * Every core has its own work queue, drained by k_work_user_wait() on that
+ * core. Submitting from another core goes through a lock-free inbox of the
+ * target, so cores never share a queue lock.
+ */
 int k_work_user_submit(k_work_user_t *work);
+int k_work_user_submit_to_cpu(int cpu, k_work_user_t *work);
+int k_work_user_submit_noalloc_to_cpu(int cpu, k_work_user_t *work);
 int k_work_schedule(k_work_delayable_t *dwork, k_timeout_t delay);
+int k_work_schedule_for_cpu(int cpu, k_work_delayable_t *dwork, k_timeout_t delay);
 int k_work_user_wait(void);
+void k_work_user_set_notify(void (*notify)(void *user_data), void *user_data);
 
 #endif // K_CONFIG_WORKQ
 
@@ -0,0 +1,74 @@
+/*
+ * @Date: 2026-10-20 21:08:12
+ * @FilePath: \Openy_Framework\include\k_load.h
+ * @Description: CPU load measurement
+ *
+ * Enabled with K_CONFIG_LOAD. The framework marks where the core switches
+ * between work handlers, msgq handlers, HSM dispatch, the tick ISR and
+ * idle, every switch charges the cycles since the previous one to the
+ * activity that was running. Time outside all of them (k_run bookkeeping,
+ * user ISRs, main loop code) is K_LOAD_OTHER. Once a second the counters
+ * are moved into a history, from which 1 to K_CONFIG_LOAD_HISTORY second
+ * windows are reported. When disabled the hooks compile to nothing.
+ */
+#ifndef __K_LOAD_H
+#define __K_LOAD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "k_config.h"
+
+enum k_load_cat {
+    K_LOAD_OTHER,
+    K_LOAD_WORK,
+    K_LOAD_MSGQ,
+    K_LOAD_HSM,
+    K_LOAD_TIMER,
+    K_LOAD_IDLE,
+    K_LOAD_NUM,
+};
+
+#ifdef K_CONFIG_LOAD
+
+/* seconds of history, the longest window reported */
+#ifndef K_CONFIG_LOAD_HISTORY
+#define K_CONFIG_LOAD_HISTORY 60
+#endif
+
+struct k_load_stats {
+    /** Seconds actually covered, less than asked right after start */
+    uint32_t seconds;
+    uint64_t total_cycles;
+    uint64_t cycles[K_LOAD_NUM];
+};
+
+uint8_t z_load_switch(uint8_t cat);
+
+void k_load_init(void);
+int k_load_get(int cpu, uint32_t seconds, struct k_load_stats *stats);
+uint32_t k_load_permille(int cpu, uint32_t seconds);
+void k_load_dump(void);
+
+#define K_LOAD_ENTER(prev_, cat_) uint8_t prev_ = z_load_switch(cat_)
+#define K_LOAD_EXIT(prev_)        (void)z_load_switch(prev_)
+
+#else
+
+#define K_LOAD_ENTER(prev_, cat_)                                                                  \
+    do {                                                                                           \
+    } while (0)
+#define K_LOAD_EXIT(prev_)                                                                         \
+    do {                                                                                           \
+    } while (0)
+
+#endif // K_CONFIG_LOAD
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __K_LOAD_H
@@ -0,0 +1,71 @@
+/*
+ * @Date: 2026-10-20 13:40:18
+ * @FilePath: \Openy_Framework\include\k_malloc_track.h
+ * @Description: Accounting and leak tracking behind K_MALLOC/K_FREE
+ *
+ * Enabled with K_CONFIG_MALLOC_TRACK, K_MALLOC/K_FREE then route through
+ * k_malloc_track()/k_free_track(). When disabled nothing here is compiled
+ * and K_MALLOC maps straight to the allocator.
+ */
+#ifndef __K_MALLOC_TRACK_H
+#define __K_MALLOC_TRACK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "k_config.h"
+
+#ifdef K_CONFIG_MALLOC_TRACK
+
+/* call sites tracked individually, further sites share the last entry */
+#ifndef K_CONFIG_MALLOC_TRACK_SITES
+#define K_CONFIG_MALLOC_TRACK_SITES 16
+#endif
+
+/* size histogram bucket n counts sizes in [2^(n-1), 2^n), the last bucket
+ * everything above
+ */
+#define K_MALLOC_TRACK_HIST_BUCKETS 13
+
+struct k_malloc_track_site {
+    /** NULL for an unused entry, "other" for the overflow entry */
+    const char *file;
+    int line;
+    /** Bytes and blocks currently allocated from this site */
+    size_t cur_bytes;
+    size_t peak_bytes;
+    uint32_t cur_count;
+    uint32_t total_count;
+};
+
+struct k_malloc_track_stats {
+    size_t cur_bytes;
+    size_t peak_bytes;
+    uint32_t cur_count;
+    uint32_t total_count;
+    uint32_t fail_count;
+    uint32_t hist[K_MALLOC_TRACK_HIST_BUCKETS];
+};
+
+typedef void (*k_malloc_track_cb_t)(const void *ptr, size_t size, const char *file, int line,
+                                    void *user_data);
+
+void *k_malloc_track(size_t size, const char *file, int line);
+void k_free_track(void *ptr);
+
+void k_malloc_track_stats_get(struct k_malloc_track_stats *stats);
+int k_malloc_track_site_get(int index, struct k_malloc_track_site *site);
+void k_malloc_track_foreach(k_malloc_track_cb_t cb, void *user_data);
+void k_malloc_track_dump(void);
+
+#endif // K_CONFIG_MALLOC_TRACK
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __K_MALLOC_TRACK_H
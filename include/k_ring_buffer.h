@@ -11,6 +11,8 @@
 #include <errno.h>
 #include <stdint.h>
 
+#include "k_stats.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -47,6 +49,9 @@ struct ring_buf {
     int32_t get_tail;
     int32_t get_base;
     uint32_t size;
+#ifdef K_CONFIG_OBJ_STATS
+    struct k_obj_stats stats;
+#endif
     /** @endcond */
 };
 
@@ -148,6 +153,7 @@ static inline void ring_buf_init(struct ring_buf *buf, uint32_t size, uint8_t *d
     buf->size = size;
     buf->buffer = data;
     ring_buf_internal_reset(buf, 0);
+    K_OBJ_STATS_INIT(&buf->stats, K_OBJ_STATS_RING_BUF, size);
 }
 
 /**
@@ -187,7 +193,10 @@ static inline bool ring_buf_is_empty(struct ring_buf *buf) {
  *
  * @param buf Address of ring buffer.
  */
-static inline void ring_buf_reset(struct ring_buf *buf) { ring_buf_internal_reset(buf, 0); }
+static inline void ring_buf_reset(struct ring_buf *buf) {
+    ring_buf_internal_reset(buf, 0);
+    K_OBJ_STATS_GET(&buf->stats, 0, 0);
+}
 
 /**
  * @brief Determine free space in a ring buffer.
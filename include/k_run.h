@@ -0,0 +1,64 @@
+/*
+ * @Date: 2026-10-19 21:02:15
+ * @FilePath: \Openy_Framework\include\k_run.h
+ * @Description: Event-driven run loop dispatching work queue, msgq and HSM sources
+ */
+#ifndef __K_RUN_H
+#define __K_RUN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "k_kernel.h"
+#include "k_hsm.h"
+
+#ifdef K_CONFIG_RUN
+
+/* One ready bit per source, the bit index is the priority (0 is highest) */
+#define K_RUN_MAX_SOURCES 32
+
+#ifndef K_CONFIG_RUN_MSG_SIZE_MAX
+#define K_CONFIG_RUN_MSG_SIZE_MAX 32
+#endif
+
+typedef struct k_run_src k_run_src_t;
+typedef void (*k_run_msg_handler_t)(k_msgq_t *msgq, void *msg);
+
+enum k_run_src_type { K_RUN_SRC_WORKQ, K_RUN_SRC_MSGQ, K_RUN_SRC_HSM };
+
+struct k_run_src {
+    uint8_t type;
+    uint8_t prio;
+    /** Max items handled per dispatch before higher priorities are re-checked */
+    uint16_t budget;
+    union {
+        k_msgq_t *msgq;
+        k_hsm_t *hsm;
+    } obj;
+    k_run_msg_handler_t handler;
+#ifdef K_CONFIG_SMP
+    /** Core that added the source and dispatches it */
+    uint8_t cpu;
+#endif
+};
+
+int k_run_add_workq(k_run_src_t *src, uint8_t prio, uint16_t budget);
+int k_run_add_msgq(k_run_src_t *src, uint8_t prio, uint16_t budget, k_msgq_t *msgq,
+                   k_run_msg_handler_t handler);
+int k_run_add_hsm(k_run_src_t *src, uint8_t prio, uint16_t budget, k_hsm_t *hsm);
+void k_run_remove(k_run_src_t *src);
+void k_run_signal(uint8_t prio);
+bool k_run_once(void);
+void k_run(void);
+
+#endif // K_CONFIG_RUN
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __K_RUN_H
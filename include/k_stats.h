@@ -0,0 +1,84 @@
+/*
+ * @Date: 2026-10-20 09:14:26
+ * @FilePath: \Openy_Framework\include\k_stats.h
+ * @Description: Occupancy and drop statistics for k_msgq, k_queue and ring_buf
+ *
+ * Enabled with K_CONFIG_OBJ_STATS. When disabled the hooks compile to
+ * nothing and the objects carry no extra fields.
+ */
+#ifndef __K_STATS_H
+#define __K_STATS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "k_config.h"
+
+#ifdef K_CONFIG_OBJ_STATS
+
+enum k_obj_stats_type { K_OBJ_STATS_MSGQ, K_OBJ_STATS_QUEUE, K_OBJ_STATS_RING_BUF };
+
+struct k_obj_stats {
+    /** Optional name given with k_obj_stats_register() */
+    const char *name;
+    /** Next object in the registry */
+    struct k_obj_stats *next;
+    uint8_t type;
+    bool registered;
+    bool full;
+    /** Capacity in messages (msgq) or bytes (ring_buf), 0 if unbounded (queue) */
+    uint32_t capacity;
+    /** Current and peak occupancy, same unit as capacity */
+    uint32_t used;
+    uint32_t high_water;
+    uint32_t puts;
+    uint32_t gets;
+    uint32_t put_fails;
+    /** Tick at which the object last became full */
+    uint32_t full_since;
+    /** Ticks spent full, not counting the current full period */
+    uint32_t full_ticks;
+};
+
+typedef void (*k_obj_stats_cb_t)(const struct k_obj_stats *snapshot, void *user_data);
+
+void k_obj_stats_register(struct k_obj_stats *stats, uint8_t type, const char *name);
+void k_obj_stats_reset(struct k_obj_stats *stats);
+void k_obj_stats_foreach(k_obj_stats_cb_t cb, void *user_data);
+
+/* hooks, called from within the objects' critical sections */
+void z_obj_stats_init(struct k_obj_stats *stats, uint8_t type, uint32_t capacity);
+void z_obj_stats_put(struct k_obj_stats *stats, uint8_t type, uint32_t n_ok, uint32_t n_fail,
+                     uint32_t used, uint32_t capacity);
+void z_obj_stats_get(struct k_obj_stats *stats, uint32_t n, uint32_t used);
+
+#define K_OBJ_STATS_PUT(stats_, type_, n_ok_, n_fail_, used_, capacity_)                           \
+    z_obj_stats_put((stats_), (type_), (n_ok_), (n_fail_), (used_), (capacity_))
+#define K_OBJ_STATS_GET(stats_, n_, used_) z_obj_stats_get((stats_), (n_), (used_))
+#define K_OBJ_STATS_INIT(stats_, type_, capacity_) z_obj_stats_init((stats_), (type_), (capacity_))
+
+#else
+
+#define K_OBJ_STATS_PUT(stats_, type_, n_ok_, n_fail_, used_, capacity_)                           \
+    do {                                                                                           \
+        (void)(n_ok_);                                                                             \
+        (void)(n_fail_);                                                                           \
+    } while (0)
+#define K_OBJ_STATS_GET(stats_, n_, used_)                                                         \
+    do {                                                                                           \
+    } while (0)
+#define K_OBJ_STATS_INIT(stats_, type_, capacity_)                                                 \
+    do {                                                                                           \
+    } while (0)
+
+#endif // K_CONFIG_OBJ_STATS
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __K_STATS_H
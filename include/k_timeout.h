@@ -162,8 +162,18 @@ struct _timeout {
     sys_dnode_t node;
     _timeout_func_t fn;
     int32_t dticks;
+#ifdef K_CONFIG_SMP
+    /** Core whose list holds the timeout */
+    uint8_t cpu;
+#endif
 };
 
+#ifdef K_CONFIG_SMP
+#define Z_TIMEOUT_CPU(to) ((to)->cpu)
+#else
+#define Z_TIMEOUT_CPU(to) 0
+#endif
+
 void k_timeout_add(struct _timeout *to, _timeout_func_t fn, k_timeout_t timeout);
 int k_timeout_abort(struct _timeout *to);
 void sys_clock_announce(int32_t ticks);
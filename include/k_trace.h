@@ -0,0 +1,108 @@
+/*
+ * @Date: 2026-10-20 19:25:40
+ * @FilePath: \Openy_Framework\include\k_trace.h
+ * @Description: Binary event tracing of timeouts, work, msgq and HSM
+ *
+ * Enabled with K_CONFIG_TRACE. Every hook appends a 16-byte record with a
+ * k_cycle_get_32() timestamp to a RAM ring buffer, overwriting the oldest
+ * ones. k_trace_dump() streams the buffer out, tools/k_trace_decode.py
+ * turns the dump into Chrome trace_event JSON (Perfetto) or CTF. When
+ * disabled the hooks compile to nothing.
+ */
+#ifndef __K_TRACE_H
+#define __K_TRACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "k_config.h"
+
+/* record ids, keep in sync with tools/k_trace_decode.py */
+enum k_trace_id {
+    K_TRACE_ID_TIMEOUT_ADD = 1,
+    K_TRACE_ID_TIMEOUT_ABORT,
+    K_TRACE_ID_TIMEOUT_EXPIRE,
+    K_TRACE_ID_TIMEOUT_EXPIRE_END,
+    K_TRACE_ID_WORK_SUBMIT,
+    K_TRACE_ID_WORK_START,
+    K_TRACE_ID_WORK_END,
+    K_TRACE_ID_MSGQ_PUT,
+    K_TRACE_ID_MSGQ_GET,
+    K_TRACE_ID_MSGQ_FULL,
+    K_TRACE_ID_HSM_DISPATCH,
+    K_TRACE_ID_HSM_DISPATCH_END,
+    K_TRACE_ID_HSM_TRAN,
+};
+
+#ifdef K_CONFIG_TRACE
+
+/* records kept, a power of 2 */
+#ifndef K_CONFIG_TRACE_EVENTS
+#define K_CONFIG_TRACE_EVENTS 256
+#endif
+
+#define K_TRACE_MAGIC   "KTRC"
+#define K_TRACE_VERSION 1
+
+struct k_trace_event {
+    uint32_t timestamp;
+    uint8_t id;
+    uint8_t cpu;
+    uint16_t reserved;
+    /** Address of the object */
+    uint32_t obj;
+    /** Event specific: ticks, queue depth, signal, target state... */
+    uint32_t arg;
+};
+
+/* Dump header, followed by count records, oldest first, little-endian */
+struct k_trace_header {
+    char magic[4];
+    uint16_t version;
+    uint16_t record_size;
+    uint32_t cycles_per_sec;
+    uint32_t count;
+};
+
+typedef void (*k_trace_write_t)(const void *data, size_t len, void *user_data);
+
+void z_trace_event(uint8_t id, const void *obj, uint32_t arg);
+
+void k_trace_enable(bool enable);
+void k_trace_clear(void);
+void k_trace_dump(k_trace_write_t write, void *user_data);
+
+#define K_TRACE(id_, obj_, arg_) z_trace_event((id_), (obj_), (uint32_t)(arg_))
+
+#else
+
+#define K_TRACE(id_, obj_, arg_)                                                                   \
+    do {                                                                                           \
+    } while (0)
+
+#endif // K_CONFIG_TRACE
+
+#define K_TRACE_TIMEOUT_ADD(to_, ticks_)   K_TRACE(K_TRACE_ID_TIMEOUT_ADD, (to_), (ticks_))
+#define K_TRACE_TIMEOUT_ABORT(to_)         K_TRACE(K_TRACE_ID_TIMEOUT_ABORT, (to_), 0)
+#define K_TRACE_TIMEOUT_EXPIRE(to_)        K_TRACE(K_TRACE_ID_TIMEOUT_EXPIRE, (to_), 0)
+#define K_TRACE_TIMEOUT_EXPIRE_END(to_)    K_TRACE(K_TRACE_ID_TIMEOUT_EXPIRE_END, (to_), 0)
+#define K_TRACE_WORK_SUBMIT(work_, cpu_)   K_TRACE(K_TRACE_ID_WORK_SUBMIT, (work_), (cpu_))
+#define K_TRACE_WORK_START(work_)          K_TRACE(K_TRACE_ID_WORK_START, (work_), 0)
+#define K_TRACE_WORK_END(work_)            K_TRACE(K_TRACE_ID_WORK_END, (work_), 0)
+#define K_TRACE_MSGQ_PUT(msgq_, used_)     K_TRACE(K_TRACE_ID_MSGQ_PUT, (msgq_), (used_))
+#define K_TRACE_MSGQ_GET(msgq_, used_)     K_TRACE(K_TRACE_ID_MSGQ_GET, (msgq_), (used_))
+#define K_TRACE_MSGQ_FULL(msgq_)           K_TRACE(K_TRACE_ID_MSGQ_FULL, (msgq_), 0)
+#define K_TRACE_HSM_DISPATCH(hsm_, sig_)   K_TRACE(K_TRACE_ID_HSM_DISPATCH, (hsm_), (sig_))
+#define K_TRACE_HSM_DISPATCH_END(hsm_)     K_TRACE(K_TRACE_ID_HSM_DISPATCH_END, (hsm_), 0)
+#define K_TRACE_HSM_TRAN(hsm_, target_)    K_TRACE(K_TRACE_ID_HSM_TRAN, (hsm_), (uintptr_t)(target_))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __K_TRACE_H
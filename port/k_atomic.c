@@ -0,0 +1,473 @@
+/*
+ * @Date: 2026-10-21 09:12:40
+ * @FilePath: \Openy_Framework\port\k_atomic.c
+ * @Description: Atomic operations
+ *
+ * Cortex-M3 and up use LDREX/STREX from CMSIS, with a DMB on each side of
+ * every read-modify-write so they order surrounding accesses like the
+ * __atomic builtins used on other targets do.
+ */
+#include "k_kernel.h"
+#if defined(__arm__) || defined(__ARMCC_VERSION)
+#include "main.h"
+#endif
+
+#define ATOMIC_BITS            (sizeof(atomic_t) * 8)
+#define ATOMIC_MASK(bit)       BIT((unsigned long)(bit) & (ATOMIC_BITS - 1U))
+#define ATOMIC_ELEM(addr, bit) ((addr) + ((bit) / ATOMIC_BITS))
+
+/**
+ *
+ * @brief Atomic addition.
+ *
+ * This routine performs an atomic addition on @a target.
+ *
+ * @note As for all atomic APIs, includes a
+ * full/sequentially-consistent memory barrier (where applicable).
+ *
+ * @param target Address of atomic variable.
+ * @param value Value to add.
+ *
+ * @return Previous value of @a target.
+ */
+atomic_t atomic_add(atomic_t *target, atomic_t value) {
+#ifdef __CM_CMSIS_VERSION
+    atomic_t prev_val;
+
+    __DMB();
+    do {
+        prev_val = __LDREXW((__IO uint32_t *)target);
+    } while ((__STREXW(prev_val + (value), (__IO uint32_t *)target)) != 0);
+    __DMB();
+    return prev_val;
+#else
+    return __atomic_fetch_add(target, value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/**
+ *
+ * @brief Atomic subtraction.
+ *
+ * This routine performs an atomic subtraction on @a target.
+ *
+ * @note As for all atomic APIs, includes a
+ * full/sequentially-consistent memory barrier (where applicable).
+ *
+ * @param target Address of atomic variable.
+ * @param value Value to subtract.
+ *
+ * @return Previous value of @a target.
+ */
+atomic_t atomic_sub(atomic_t *target, atomic_t value) {
+#ifdef __CM_CMSIS_VERSION
+    atomic_t prev_val;
+
+    __DMB();
+    do {
+        prev_val = __LDREXW((__IO uint32_t *)target);
+    } while ((__STREXW(prev_val - (value), (__IO uint32_t *)target)) != 0);
+    __DMB();
+    return prev_val;
+#else
+    return __atomic_fetch_sub(target, value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/**
+ *
+ * @brief Atomic increment.
+ *
+ * @param target Address of atomic variable.
+ *
+ * @return Previous value of @a target.
+ */
+atomic_t atomic_inc(atomic_t *target) { return atomic_add(target, 1); }
+
+/**
+ *
+ * @brief Atomic decrement.
+ *
+ * @param target Address of atomic variable.
+ *
+ * @return Previous value of @a target.
+ */
+atomic_t atomic_dec(atomic_t *target) { return atomic_sub(target, 1); }
+
+/**
+ *
+ * @brief Atomic bitwise exclusive OR (XOR).
+ *
+ * This routine atomically sets @a target to the bitwise exclusive OR (XOR)
+ * of @a target and @a value.
+ *
+ * @note As for all atomic APIs, includes a
+ * full/sequentially-consistent memory barrier (where applicable).
+ *
+ * @param target Address of atomic variable.
+ * @param value Value to XOR
+ *
+ * @return Previous value of @a target.
+ */
+atomic_t atomic_xor(atomic_t *target, atomic_t value) {
+#ifdef __CM_CMSIS_VERSION
+    atomic_t prev_val;
+
+    __DMB();
+    do {
+        prev_val = __LDREXW((__IO uint32_t *)target);
+    } while ((__STREXW(prev_val ^ (value), (__IO uint32_t *)target)) != 0);
+    __DMB();
+    return prev_val;
+#else
+    return __atomic_fetch_xor(target, value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/**
+ *
+ * @brief Atomic bitwise NAND.
+ *
+ * This routine atomically sets @a target to the bitwise NAND of @a target
+ * and @a value. (This operation is equivalent to target = ~(target & value).)
+ *
+ * @note As for all atomic APIs, includes a
+ * full/sequentially-consistent memory barrier (where applicable).
+ *
+ * @param target Address of atomic variable.
+ * @param value Value to NAND.
+ *
+ * @return Previous value of @a target.
+ */
+atomic_t atomic_nand(atomic_t *target, atomic_t value) {
+#ifdef __CM_CMSIS_VERSION
+    atomic_t prev_val;
+
+    __DMB();
+    do {
+        prev_val = __LDREXW((__IO uint32_t *)target);
+    } while ((__STREXW(~(prev_val & (value)), (__IO uint32_t *)target)) != 0);
+    __DMB();
+    return prev_val;
+#else
+    return __atomic_fetch_nand(target, value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/**
+ *
+ * @brief Atomic bitwise AND.
+ *
+ * This routine atomically sets @a target to the bitwise AND of @a target
+ * and @a value.
+ *
+ * @note As for all atomic APIs, includes a
+ * full/sequentially-consistent memory barrier (where applicable).
+ *
+ * @param target Address of atomic variable.
+ * @param value Value to AND.
+ *
+ * @return Previous value of @a target.
+ */
+atomic_t atomic_and(atomic_t *target, atomic_t value) {
+#ifdef __CM_CMSIS_VERSION
+    atomic_t prev_val;
+
+    __DMB();
+    do {
+        prev_val = __LDREXW((__IO uint32_t *)target);
+    } while ((__STREXW(prev_val & (value), (__IO uint32_t *)target)) != 0);
+    __DMB();
+    return prev_val;
+#else
+    return __atomic_fetch_and(target, value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/**
+ *
+ * @brief Atomic bitwise inclusive OR.
+ *
+ * This routine atomically sets @a target to the bitwise inclusive OR of
+ * @a target and @a value.
+ *
+ * @note As for all atomic APIs, includes a
+ * full/sequentially-consistent memory barrier (where applicable).
+ *
+ * @param target Address of atomic variable.
+ * @param value Value to OR.
+ *
+ * @return Previous value of @a target.
+ */
+atomic_t atomic_or(atomic_t *target, atomic_t value) {
+#ifdef __CM_CMSIS_VERSION
+    atomic_t prev_val;
+
+    __DMB();
+    do {
+        prev_val = __LDREXW((__IO uint32_t *)target);
+    } while ((__STREXW(prev_val | (value), (__IO uint32_t *)target)) != 0);
+    __DMB();
+    return prev_val;
+#else
+    return __atomic_fetch_or(target, value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/**
+ * @brief Atomically set a bit.
+ *
+ * Atomically set bit number @a bit of @a target and return its old value.
+ * The target may be a single atomic variable or an array of them.
+ *
+ * @note As for all atomic APIs, includes a
+ * full/sequentially-consistent memory barrier (where applicable).
+ *
+ * @param target Address of atomic variable or array.
+ * @param bit Bit number (starting from 0).
+ *
+ * @return true if the bit was set, false if it wasn't.
+ */
+bool atomic_test_and_set_bit(atomic_t *target, int bit) {
+    atomic_t old;
+    atomic_t mask = ATOMIC_MASK(bit);
+
+    old = atomic_or(ATOMIC_ELEM(target, bit), mask);
+
+    return (old & mask) != 0;
+}
+
+/**
+ * @brief Atomically test and clear a bit.
+ *
+ * Atomically clear bit number @a bit of @a target and return its old value.
+ * The target may be a single atomic variable or an array of them.
+ *
+ * @note As for all atomic APIs, includes a
+ * full/sequentially-consistent memory barrier (where applicable).
+ *
+ * @param target Address of atomic variable or array.
+ * @param bit Bit number (starting from 0).
+ *
+ * @return true if the bit was set, false if it wasn't.
+ */
+bool atomic_test_and_clear_bit(atomic_t *target, int bit) {
+    atomic_t old;
+    atomic_t mask = ATOMIC_MASK(bit);
+
+    old = atomic_and(ATOMIC_ELEM(target, bit), ~mask);
+
+    return (old & mask) != 0;
+}
+
+void atomic_clear_bit(atomic_t *target, int bit) {
+    atomic_t mask = ATOMIC_MASK(bit);
+    
+    (void)atomic_and(ATOMIC_ELEM(target, bit), ~mask);
+}
+
+/**
+ * @brief Atomically set a bit.
+ *
+ * Atomically set bit number @a bit of @a target.
+ * The target may be a single atomic variable or an array of them.
+ *
+ * @param target Address of atomic variable or array.
+ * @param bit Bit number (starting from 0).
+ */
+void atomic_set_bit(atomic_t *target, int bit) {
+    atomic_t mask = ATOMIC_MASK(bit);
+
+    (void)atomic_or(ATOMIC_ELEM(target, bit), mask);
+}
+
+/**
+ * @brief Atomically set a bit to a given value.
+ *
+ * @param target Address of atomic variable or array.
+ * @param bit Bit number (starting from 0).
+ * @param val true for 1, false for 0.
+ */
+void atomic_set_bit_to(atomic_t *target, int bit, bool val) {
+    if (val) {
+        atomic_set_bit(target, bit);
+    } else {
+        atomic_clear_bit(target, bit);
+    }
+}
+
+/**
+ * @brief Atomically test a bit.
+ *
+ * @param target Address of atomic variable or array.
+ * @param bit Bit number (starting from 0).
+ *
+ * @return true if the bit was set, false if it wasn't.
+ */
+bool atomic_test_bit(const atomic_t *target, int bit) {
+    atomic_t val = atomic_get(ATOMIC_ELEM(target, bit));
+
+    return (val & ATOMIC_MASK(bit)) != 0;
+}
+
+/**
+ * @brief Atomic get.
+ *
+ * This routine performs an atomic read on @a target, with acquire/release
+ * ordering against surrounding memory accesses.
+ *
+ * @param target Address of atomic variable.
+ *
+ * @return Value of @a target.
+ */
+atomic_t atomic_get(const atomic_t *target) {
+#ifdef __CM_CMSIS_VERSION
+    atomic_t val;
+
+    __DMB();
+    val = *(volatile const atomic_t *)target;
+    __DMB();
+    return val;
+#else
+    return __atomic_load_n(target, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/**
+ * @brief Atomic assignment.
+ *
+ * This routine atomically sets @a target to @a value.
+ *
+ * @note As for all atomic APIs, includes a
+ * full/sequentially-consistent memory barrier (where applicable).
+ *
+ * @param target Address of atomic variable.
+ * @param value Value to write to @a target.
+ *
+ * @return Previous value of @a target.
+ */
+atomic_t atomic_set(atomic_t *target, atomic_t value) {
+#ifdef __CM_CMSIS_VERSION
+    atomic_t prev_val;
+
+    __DMB();
+    do {
+        prev_val = __LDREXW((__IO uint32_t *)target);
+    } while ((__STREXW(value, (__IO uint32_t *)target)) != 0);
+    __DMB();
+    return prev_val;
+#else
+    return __atomic_exchange_n(target, value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/**
+ * @brief Atomic compare-and-set.
+ *
+ * This routine performs an atomic compare-and-set on @a target. If the
+ * current value of @a target equals @a old_value, @a target is set to
+ * @a new_value. If the current value of @a target does not equal
+ * @a old_value, @a target is left unchanged.
+ *
+ * @note As for all atomic APIs, includes a
+ * full/sequentially-consistent memory barrier (where applicable).
+ *
+ * @param target Address of atomic variable.
+ * @param old_value Original value to compare against.
+ * @param new_value New value to store.
+ *
+ * @return true if @a new_value is written, false otherwise.
+ */
+bool atomic_cas(atomic_t *target, atomic_t old_value, atomic_t new_value) {
+#ifdef __CM_CMSIS_VERSION
+    __DMB();
+    do {
+        if (__LDREXW((__IO uint32_t *)target) != (uint32_t)old_value) {
+            __CLREX();
+            __DMB();
+            return false;
+        }
+    } while ((__STREXW((uint32_t)new_value, (__IO uint32_t *)target)) != 0);
+    __DMB();
+    return true;
+#else
+    return __atomic_compare_exchange_n(target, &old_value, new_value, false, __ATOMIC_SEQ_CST,
+                                       __ATOMIC_SEQ_CST);
+#endif
+}
+
+/**
+ * @brief Atomic compare-and-set with pointer values.
+ *
+ * Same as atomic_cas() on a pointer sized variable.
+ *
+ * @param target Address of atomic variable.
+ * @param old_value Original value to compare against.
+ * @param new_value New value to store.
+ *
+ * @return true if @a new_value is written, false otherwise.
+ */
+bool atomic_ptr_cas(atomic_ptr_t *target, void *old_value, void *new_value) {
+#ifdef __CM_CMSIS_VERSION
+    return atomic_cas((atomic_t *)target, (atomic_t)old_value, (atomic_t)new_value);
+#else
+    return __atomic_compare_exchange_n(target, &old_value, new_value, false, __ATOMIC_SEQ_CST,
+                                       __ATOMIC_SEQ_CST);
+#endif
+}
+
+/**
+ * @brief Atomic clear.
+ *
+ * This routine atomically sets @a target to zero and returns its previous
+ * value. (Hence, it is equivalent to atomic_set(target, 0).)
+ *
+ * @param target Address of atomic variable.
+ *
+ * @return Previous value of @a target.
+ */
+atomic_t atomic_clear(atomic_t *target) { return atomic_set(target, 0); }
+
+/**
+ * @brief Atomic get a pointer value
+ *
+ * This routine performs an atomic read on @a target.
+ *
+ * @param target Address of pointer variable.
+ *
+ * @return Value of @a target.
+ */
+void *atomic_ptr_get(const atomic_ptr_t *target) {
+#ifdef __CM_CMSIS_VERSION
+    return (void *)atomic_get((const atomic_t *)target);
+#else
+    return __atomic_load_n(target, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/**
+ * @brief Atomic swap of a pointer value.
+ *
+ * This routine atomically sets @a target to @a value.
+ *
+ * @param target Address of atomic variable.
+ * @param value Value to write to @a target.
+ *
+ * @return Previous value of @a target.
+ */
+void *atomic_ptr_set(atomic_ptr_t *target, void *value) {
+#ifdef __CM_CMSIS_VERSION
+    return (void *)atomic_set((atomic_t *)target, (atomic_t)value);
+#else
+    return __atomic_exchange_n(target, value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/**
+ * @brief Atomic clear of a pointer value
+ *
+ * @param target Address of atomic variable.
+ *
+ * @return Previous value of @a target.
+ */
+void *atomic_ptr_clear(atomic_ptr_t *target) { return atomic_ptr_set(target, NULL); }
@@ -23,7 +23,103 @@ extern "C" {
 #define K_CONFIG_RINGBUFFER
 #define K_CONFIG_TIMER
 #define K_CONFIG_MSGQ
+#define K_CONFIG_VMSGQ
 #define K_CONFIG_WORKQ
+#define K_CONFIG_RUN
+#define K_CONFIG_MEM_SLAB
+#define K_CONFIG_HEAP
+#define K_CONFIG_LIFO
+
+/* mask interrupts by raising BASEPRI instead of setting PRIMASK, interrupts
+ * with a priority value below K_CONFIG_IRQ_BASEPRI_PRIO are then never
+ * delayed by the framework and must never call into it, every ISR that does
+ * (tick timer included) needs a priority value >= K_CONFIG_IRQ_BASEPRI_PRIO
+ */
+// #define K_CONFIG_IRQ_BASEPRI
+#define K_CONFIG_IRQ_BASEPRI_PRIO               2
+
+/* k_spin_lock() also spins on the lock word, for targets where several cores
+ * share framework objects, interrupt masking alone only covers one core
+ */
+// #define K_CONFIG_SMP
+/* cores with their own timeout list and work queue when K_CONFIG_SMP is on */
+#define K_CONFIG_MP_MAX_NUM_CPUS                2
+
+/* Sources implementing zero-latency ISRs define K_ZERO_LATENCY_ISR before
+ * their includes, reaching any framework header then fails the build.
+ */
+#ifdef K_ZERO_LATENCY_ISR
+#error "zero-latency ISRs run above the kernel mask and must not use the framework"
+#endif
+
+/* allocate k_queue_alloc_*() nodes and k_timer_create() timers from
+ * fixed slabs instead of K_MALLOC, requires K_CONFIG_MEM_SLAB
+ */
+// #define K_CONFIG_KERNEL_MEM_SLAB
+#define K_CONFIG_QUEUE_ALLOC_NODES              16
+#define K_CONFIG_TIMER_DYNAMIC_NUM              4
+
+/* back K_MALLOC/K_FREE with a TLSF k_heap instead of libc, requires K_CONFIG_HEAP */
+// #define K_CONFIG_HEAP_MALLOC
+#define K_CONFIG_HEAP_MALLOC_SIZE               4096
+/* largest heap block is 2^K_CONFIG_HEAP_FL_INDEX_MAX bytes */
+#define K_CONFIG_HEAP_FL_INDEX_MAX              16
+
+/* per call site accounting and leak list behind K_MALLOC/K_FREE (k_malloc_track.h) */
+// #define K_CONFIG_MALLOC_TRACK
+#define K_CONFIG_MALLOC_TRACK_SITES             16
+
+/* occupancy and drop counters on k_msgq, k_queue and ring_buf (k_stats.h) */
+// #define K_CONFIG_OBJ_STATS
+
+/* time every interrupt masked region with the cycle counter and charge it
+ * to the k_interrupt_disable() call site, report with k_irq_prof_dump()
+ */
+// #define K_CONFIG_IRQ_PROFILE
+#define K_CONFIG_IRQ_PROFILE_SITES              32
+
+/* record timeout, work, msgq and HSM events with cycle timestamps into a
+ * ring buffer (k_trace.h), decode k_trace_dump() with tools/k_trace_decode.py
+ */
+// #define K_CONFIG_TRACE
+#define K_CONFIG_TRACE_EVENTS                   256
+
+/* charge cycles to work/msgq/hsm/timer/idle and keep a per second history
+ * for 1s/10s/60s load figures (k_load.h), start with k_load_init()
+ */
+// #define K_CONFIG_LOAD
+#define K_CONFIG_LOAD_HISTORY                   60
+
+/* most verbose log severity compiled in: 0 none, 1 error, 2 info, 3 debug,
+ * lower calls cost nothing, not even their arguments
+ */
+#define K_CONFIG_LOG_LEVEL                      3
+/* K_LOG_*_RATELIMIT: at most BURST messages per call site and window */
+#define K_CONFIG_LOG_RATELIMIT_MS               1000
+#define K_CONFIG_LOG_RATELIMIT_BURST            5
+
+/* K_LOG_* queue format and arguments into a lock-free ring, formatted and
+ * written to the k_log_backend list later by k_log_process(), from k_run()
+ * idle or a work item
+ */
+// #define K_CONFIG_LOG_DEFERRED
+#define K_CONFIG_LOG_MSGS                       32
+#define K_CONFIG_LOG_MSG_WORDS                  6
+#define K_CONFIG_LOG_LINE_SIZE                  128
+/* with K_CONFIG_LOG_DEFERRED: send format string ids and raw arguments,
+ * decoded on the host from the ELF by tools/k_log_decode.py
+ */
+// #define K_CONFIG_LOG_DICTIONARY
+
+/* number of priority bands of a k_msgq_prio, at most 32 */
+#define K_CONFIG_MSGQ_PRIO_BANDS                4
+
+/* largest msg_size of a msgq registered with k_run_add_msgq() */
+#define K_CONFIG_RUN_MSG_SIZE_MAX               32
+
+/* C++20 coroutine frames (k_coro.hpp), allocated from a fixed pool */
+#define K_CONFIG_CORO_FRAME_SIZE                256
+#define K_CONFIG_CORO_FRAME_COUNT               4
 
 #ifdef __cplusplus
 }
@@ -16,6 +16,11 @@ extern "C" {
 
 #include <stdio.h>
 #include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "k_config.h"
 
 #define K_LOG_OUTPUT_STREAM stdout
 
@@ -25,9 +30,254 @@ extern "C" {
 
 void k_print(int level, const char *fmt, ...);
 
-#define K_LOG_INFO(format, ...)  k_print(K_LOG_LEVEL_INFO, (format), ##__VA_ARGS__)
-#define K_LOG_DEBUG(format, ...) k_print(K_LOG_LEVEL_DEBUG, (format), ##__VA_ARGS__)
-#define K_LOG_ERROR(format, ...) k_print(K_LOG_LEVEL_ERROR, (format), ##__VA_ARGS__)
+#ifdef K_CONFIG_LOG_DEFERRED
+
+/*
+ * Deferred mode: K_LOG_* only copy the format pointer and the arguments
+ * into a lock-free ring, usable from ISRs. k_log_process() formats and
+ * hands the lines to the backends later, k_run() calls it when idle.
+ * Format strings and %s arguments are kept by pointer, they must still be
+ * valid then (literals, __FILE__, static names).
+ */
+
+/* messages held by the ring, a power of 2 */
+#ifndef K_CONFIG_LOG_MSGS
+#define K_CONFIG_LOG_MSGS 32
+#endif
+/* argument words per message, a double or long long takes 2 on 32-bit */
+#ifndef K_CONFIG_LOG_MSG_WORDS
+#define K_CONFIG_LOG_MSG_WORDS 6
+#endif
+/* formatted line, longer ones are cut */
+#ifndef K_CONFIG_LOG_LINE_SIZE
+#define K_CONFIG_LOG_LINE_SIZE 128
+#endif
+
+struct k_log_backend {
+    /**
+     * Gets one complete line, newline included, from k_log_process(). With
+     * K_CONFIG_LOG_DICTIONARY one binary record instead.
+     */
+    void (*write)(const struct k_log_backend *backend, const char *data, size_t len);
+    void *user_data;
+    struct k_log_backend *next;
+};
+
+struct k_log_overflow {
+    /** Messages lost because the ring was full */
+    uint32_t dropped;
+    /** Messages with arguments beyond K_CONFIG_LOG_MSG_WORDS or a line cut */
+    uint32_t truncated;
+};
+
+/* fwrite() to the FILE * in user_data, K_LOG_OUTPUT_STREAM when NULL */
+void k_log_backend_fwrite(const struct k_log_backend *backend, const char *data, size_t len);
+extern struct k_log_backend k_log_backend_stdout;
+
+void z_log_put(int level, const char *fmt, ...);
+
+void k_log_backend_add(struct k_log_backend *backend);
+bool k_log_process(void);
+void k_log_flush(void);
+void k_log_overflow_get(struct k_log_overflow *overflow);
+
+#ifdef K_CONFIG_LOG_DICTIONARY
+
+/*
+ * Dictionary mode: the format string goes to section K_LOG_DICT_SECTION
+ * and its address is the message id. The MCU never reads it, so the
+ * section can be left out of the flashed image (NOLOAD/INFO in a GNU
+ * linker script). The argument classes are worked out at compile time,
+ * a message is the id plus the raw argument words, sent as a record
+ * that tools/k_log_decode.py turns back into text with the ELF.
+ * At most 8 arguments. %s sends the pointer, the decoder resolves it
+ * when it points into the ELF (literals, __FILE__).
+ */
+#define K_LOG_DICT_SECTION ".k_log_fmt"
+#define K_LOG_DICT_MAGIC   0xA5
+/* level of the record reporting dropped messages, its one word is the count */
+#define K_LOG_DICT_DROPPED 0xFF
+
+/* Record header, followed by words 32-bit argument words, little-endian */
+struct k_log_dict_hdr {
+    uint8_t magic;
+    uint8_t level;
+    uint8_t words;
+    uint8_t reserved;
+    /** Address of the format string */
+    uint32_t fmt;
+};
+
+/* argument classes, 2 bits per argument in the descriptor, 0 ends it */
+#define Z_LOG_ARG_WORD   1U
+#define Z_LOG_ARG_DWORD  2U
+#define Z_LOG_ARG_DOUBLE 3U
+
+#if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L)
+#define Z_LOG_ARG_CODE(x)                                                                          \
+    _Generic(1 ? (x) : 0, float: Z_LOG_ARG_DOUBLE, double: Z_LOG_ARG_DOUBLE,                       \
+             default: (sizeof(1 ? (x) : 0) > 4U ? Z_LOG_ARG_DWORD : Z_LOG_ARG_WORD))
+#else
+/* by size only: a double goes as its 64 bits, as AAPCS passes it to a
+ * variadic function, a float argument must be cast to double
+ */
+#define Z_LOG_ARG_CODE(x) (sizeof(1 ? (x) : 0) > 4U ? Z_LOG_ARG_DWORD : Z_LOG_ARG_WORD)
+#endif
+
+/* count the format too, so no macro below ever gets an empty argument list */
+#define Z_LOG_NARGS(...) Z_LOG_NARGS_(__VA_ARGS__, 9, 8, 7, 6, 5, 4, 3, 2, 1, _)
+#define Z_LOG_NARGS_(_1, _2, _3, _4, _5, _6, _7, _8, _9, n, ...) n
+
+#define Z_LOG_DESC(...)        Z_LOG_CAT(Z_LOG_DESC_, Z_LOG_NARGS(__VA_ARGS__))(__VA_ARGS__)
+#define Z_LOG_DESC_ARG(a)      ((uint32_t)Z_LOG_ARG_CODE(a))
+#define Z_LOG_DESC_1(f)        0U
+#define Z_LOG_DESC_2(f, a)     Z_LOG_DESC_ARG(a)
+#define Z_LOG_DESC_3(f, a, ...) (Z_LOG_DESC_ARG(a) | (Z_LOG_DESC_2(f, __VA_ARGS__) << 2))
+#define Z_LOG_DESC_4(f, a, ...) (Z_LOG_DESC_ARG(a) | (Z_LOG_DESC_3(f, __VA_ARGS__) << 2))
+#define Z_LOG_DESC_5(f, a, ...) (Z_LOG_DESC_ARG(a) | (Z_LOG_DESC_4(f, __VA_ARGS__) << 2))
+#define Z_LOG_DESC_6(f, a, ...) (Z_LOG_DESC_ARG(a) | (Z_LOG_DESC_5(f, __VA_ARGS__) << 2))
+#define Z_LOG_DESC_7(f, a, ...) (Z_LOG_DESC_ARG(a) | (Z_LOG_DESC_6(f, __VA_ARGS__) << 2))
+#define Z_LOG_DESC_8(f, a, ...) (Z_LOG_DESC_ARG(a) | (Z_LOG_DESC_7(f, __VA_ARGS__) << 2))
+#define Z_LOG_DESC_9(f, a, ...) (Z_LOG_DESC_ARG(a) | (Z_LOG_DESC_8(f, __VA_ARGS__) << 2))
+
+void z_log_dict_put(int level, const char *fmt, uint32_t desc, ...);
+
+#define Z_LOG_DICT(level, format, ...)                                                             \
+    do {                                                                                           \
+        static const char z_log_fmt_[] __attribute__((section(K_LOG_DICT_SECTION), used)) =        \
+            format;                                                                                \
+        z_log_dict_put((level), z_log_fmt_, Z_LOG_DESC(format, ##__VA_ARGS__), ##__VA_ARGS__); \
+    } while (0)
+
+#define Z_LOG_EMIT(level, format, ...) Z_LOG_DICT(level, format, ##__VA_ARGS__)
+
+#else
+
+#define Z_LOG_EMIT(level, format, ...) z_log_put((level), (format), ##__VA_ARGS__)
+
+#endif // K_CONFIG_LOG_DICTIONARY
+
+#else
+
+#ifdef K_CONFIG_LOG_DICTIONARY
+#error "K_CONFIG_LOG_DICTIONARY requires K_CONFIG_LOG_DEFERRED"
+#endif
+
+#define Z_LOG_EMIT(level, format, ...) k_print((level), (format), ##__VA_ARGS__)
+
+#endif // K_CONFIG_LOG_DEFERRED
+
+/*
+ * Filtering. Calls above K_CONFIG_LOG_LEVEL are removed at compile time,
+ * arguments included. The others first compare with the run time level of
+ * the file's module, the arguments are evaluated only when that passes.
+ * A file joins a module by defining K_LOG_MODULE before its first include,
+ * one source instantiates it with K_LOG_MODULE_DEFINE(). Other files are
+ * in k_log_module_default.
+ */
+#define K_LOG_SEV_NONE  0
+#define K_LOG_SEV_ERROR 1
+#define K_LOG_SEV_INFO  2
+#define K_LOG_SEV_DEBUG 3
+
+#ifndef K_CONFIG_LOG_LEVEL
+#define K_CONFIG_LOG_LEVEL K_LOG_SEV_DEBUG
+#endif
+/* a rate limited call site outputs at most BURST messages per window */
+#ifndef K_CONFIG_LOG_RATELIMIT_MS
+#define K_CONFIG_LOG_RATELIMIT_MS 1000
+#endif
+#ifndef K_CONFIG_LOG_RATELIMIT_BURST
+#define K_CONFIG_LOG_RATELIMIT_BURST 5
+#endif
+
+struct k_log_module {
+    const char *name;
+    /** Most verbose K_LOG_SEV_* output, may be changed at any time */
+    volatile uint8_t level;
+};
+
+struct k_log_ratelimit {
+    uint32_t start;
+    uint16_t count;
+    /** Suppressed in the last window, reported with the next output */
+    uint16_t missed;
+};
+
+extern struct k_log_module k_log_module_default;
+
+bool z_log_ratelimit(struct k_log_ratelimit *rl);
+
+#define Z_LOG_CAT(a, b)  Z_LOG_CAT_(a, b)
+#define Z_LOG_CAT_(a, b) a##b
+
+#define K_LOG_MODULE_DEFINE(name, level_) struct k_log_module k_log_module_##name = {#name, (level_)}
+#define K_LOG_MODULE_DECLARE(name)       extern struct k_log_module k_log_module_##name
+
+#ifdef K_LOG_MODULE
+extern struct k_log_module Z_LOG_CAT(k_log_module_, K_LOG_MODULE);
+#define Z_LOG_CURRENT (&Z_LOG_CAT(k_log_module_, K_LOG_MODULE))
+#else
+#define Z_LOG_CURRENT (&k_log_module_default)
+#endif
+
+static inline void k_log_module_level_set(struct k_log_module *module, uint8_t level) {
+    module->level = level;
+}
+
+#define Z_LOG(sev_, level_, format, ...)                                                             \
+    do {                                                                                           \
+        if ((sev_) <= Z_LOG_CURRENT->level) {                                                      \
+            Z_LOG_EMIT(level_, format, ##__VA_ARGS__);                                              \
+        }                                                                                          \
+    } while (0)
+
+#define Z_LOG_RATELIMIT(sev_, level_, format, ...)                                                   \
+    do {                                                                                           \
+        static struct k_log_ratelimit z_log_rl_;                                                   \
+        if ((sev_) <= Z_LOG_CURRENT->level && z_log_ratelimit(&z_log_rl_)) {                       \
+            Z_LOG_EMIT(level_, format, ##__VA_ARGS__);                                              \
+        }                                                                                          \
+    } while (0)
+
+/* compiled out: the arguments are referenced, so they are not reported as
+ * unused, but never evaluated and no code or string is emitted
+ */
+static inline void z_log_nop(const char *fmt, ...) { (void)fmt; }
+
+#define Z_LOG_NOP(format, ...)                                                                     \
+    do {                                                                                           \
+        if (0) {                                                                                   \
+            z_log_nop((format), ##__VA_ARGS__);                                                    \
+        }                                                                                          \
+    } while (0)
+
+#if K_CONFIG_LOG_LEVEL >= K_LOG_SEV_ERROR
+#define K_LOG_ERROR(format, ...) Z_LOG(K_LOG_SEV_ERROR, K_LOG_LEVEL_ERROR, format, ##__VA_ARGS__)
+#define K_LOG_ERROR_RATELIMIT(format, ...)                                                         \
+    Z_LOG_RATELIMIT(K_LOG_SEV_ERROR, K_LOG_LEVEL_ERROR, format, ##__VA_ARGS__)
+#else
+#define K_LOG_ERROR(format, ...)           Z_LOG_NOP(format, ##__VA_ARGS__)
+#define K_LOG_ERROR_RATELIMIT(format, ...) Z_LOG_NOP(format, ##__VA_ARGS__)
+#endif
+
+#if K_CONFIG_LOG_LEVEL >= K_LOG_SEV_INFO
+#define K_LOG_INFO(format, ...) Z_LOG(K_LOG_SEV_INFO, K_LOG_LEVEL_INFO, format, ##__VA_ARGS__)
+#define K_LOG_INFO_RATELIMIT(format, ...)                                                          \
+    Z_LOG_RATELIMIT(K_LOG_SEV_INFO, K_LOG_LEVEL_INFO, format, ##__VA_ARGS__)
+#else
+#define K_LOG_INFO(format, ...)           Z_LOG_NOP(format, ##__VA_ARGS__)
+#define K_LOG_INFO_RATELIMIT(format, ...) Z_LOG_NOP(format, ##__VA_ARGS__)
+#endif
+
+#if K_CONFIG_LOG_LEVEL >= K_LOG_SEV_DEBUG
+#define K_LOG_DEBUG(format, ...) Z_LOG(K_LOG_SEV_DEBUG, K_LOG_LEVEL_DEBUG, format, ##__VA_ARGS__)
+#define K_LOG_DEBUG_RATELIMIT(format, ...)                                                         \
+    Z_LOG_RATELIMIT(K_LOG_SEV_DEBUG, K_LOG_LEVEL_DEBUG, format, ##__VA_ARGS__)
+#else
+#define K_LOG_DEBUG(format, ...)           Z_LOG_NOP(format, ##__VA_ARGS__)
+#define K_LOG_DEBUG_RATELIMIT(format, ...) Z_LOG_NOP(format, ##__VA_ARGS__)
+#endif
 
 #ifdef __cplusplus
 }
@@ -17,10 +17,30 @@ extern "C" {
 #include <stdlib.h>
 #include <string.h>
 
+#include "k_config.h"
+
 #define _K_MALLOC
 #ifdef _K_MALLOC
-#define K_MALLOC(size_)            malloc(size_)
-#define K_FREE(ptr_)               free(ptr_)
+#if defined(K_CONFIG_HEAP) && defined(K_CONFIG_HEAP_MALLOC)
+/* TLSF heap of K_CONFIG_HEAP_MALLOC_SIZE bytes, see k_heap.c */
+void *k_malloc(size_t size);
+void k_free(void *ptr);
+#define Z_MALLOC_RAW(size_)        k_malloc(size_)
+#define Z_FREE_RAW(ptr_)           k_free(ptr_)
+#else
+#define Z_MALLOC_RAW(size_)        malloc(size_)
+#define Z_FREE_RAW(ptr_)           free(ptr_)
+#endif
+
+#ifdef K_CONFIG_MALLOC_TRACK
+/* accounting layer on top of the raw allocator, see k_malloc_track.c */
+#include "k_malloc_track.h"
+#define K_MALLOC(size_)            k_malloc_track((size_), __FILE__, __LINE__)
+#define K_FREE(ptr_)               k_free_track(ptr_)
+#else
+#define K_MALLOC(size_)            Z_MALLOC_RAW(size_)
+#define K_FREE(ptr_)               Z_FREE_RAW(ptr_)
+#endif
 #define K_MEMCPY(des_, src_, len_) memcpy(des_, src_, len_)
 #endif /* _K_MALLOC */
 
@@ -7,9 +7,11 @@
 #include "k_kernel.h"
 #include "main.h"
 
-#define ATOMIC_BITS            (sizeof(atomic_t) * 8)
-#define ATOMIC_MASK(bit)       BIT((unsigned long)(bit) & (ATOMIC_BITS - 1U))
-#define ATOMIC_ELEM(addr, bit) ((addr) + ((bit) / ATOMIC_BITS))
+#ifdef K_CONFIG_IRQ_PROFILE
+/* define the primitives themselves, not the profiling wrappers */
+#undef k_interrupt_disable
+#undef k_interrupt_enable
+#endif
 
 void __attribute__((weak)) k_print(int level, const char *fmt, ...) {
     const char *level_str[] = {"[INFO] ", "[DEBUG] ", "[ERROR] "};
@@ -23,129 +25,104 @@ void __attribute__((weak)) k_print(int level, const char *fmt, ...) {
     return;
 }
 
+#ifdef K_CONFIG_IRQ_BASEPRI
+#if (K_CONFIG_IRQ_BASEPRI_PRIO <= 0) || (K_CONFIG_IRQ_BASEPRI_PRIO >= (1 << __NVIC_PRIO_BITS))
+#error "K_CONFIG_IRQ_BASEPRI_PRIO must be within 1 .. (1 << __NVIC_PRIO_BITS) - 1"
+#endif
+#define IRQ_BASEPRI_MASK ((uint32_t)K_CONFIG_IRQ_BASEPRI_PRIO << (8U - __NVIC_PRIO_BITS))
+
+/* Thread mode, or an exception allowed to use the framework. NMI and
+ * HardFault (IPSR 2, 3) have fixed negative priorities and never qualify.
+ */
+static inline bool irq_basepri_caller_ok(void) {
+    uint32_t ipsr = __get_IPSR();
+
+    return ipsr == 0U || (ipsr >= 4U && NVIC_GetPriority((IRQn_Type)((int32_t)ipsr - 16)) >=
+                                            (uint32_t)K_CONFIG_IRQ_BASEPRI_PRIO);
+}
+#endif
+
 atomic_t k_interrupt_disable(void) {
     atomic_t key;
+#ifdef K_CONFIG_IRQ_BASEPRI
+    __ASSERT(irq_basepri_caller_ok(), "framework called from zero-latency exception %u",
+             (unsigned int)__get_IPSR());
+    key = (atomic_t)__get_BASEPRI();
+    /* only ever raises the mask, nested sections keep the outer level */
+    __set_BASEPRI_MAX(IRQ_BASEPRI_MASK);
+    __ISB();
+#else
     __asm {
 		MRS 	key, PRIMASK
 		CPSID   I
     }
+#endif
     return key;
 }
 
 void k_interrupt_enable(atomic_t key) {
+#ifdef K_CONFIG_IRQ_BASEPRI
+    __set_BASEPRI((uint32_t)key);
+#else
     __asm {
 		MSR 	PRIMASK, key
     }
+#endif
 }
 
-/**
- *
- * @brief Atomic bitwise AND.
- *
- * This routine atomically sets @a target to the bitwise AND of @a target
- * and @a value.
- *
- * @note As for all atomic APIs, includes a
- * full/sequentially-consistent memory barrier (where applicable).
- *
- * @param target Address of atomic variable.
- * @param value Value to AND.
- *
- * @return Previous value of @a target.
- */
-static inline atomic_t atomic_and(atomic_t *target, atomic_t value) {
-#ifdef __CM_CMSIS_VERSION
-    atomic_t prev_val;
-    do {
-        prev_val = __LDREXW((__IO uint32_t *)target);
-    } while ((__STREXW(prev_val & (value), (__IO uint32_t *)target)) != 0);
-    return prev_val;
-#else
-    return __atomic_fetch_and(target, value, __ATOMIC_SEQ_CST);
-#endif
+void k_msleep(int32_t ms) {
+    HAL_Delay(ms);
 }
 
 /**
+ * @brief Read the DWT cycle counter, starting it on first use.
  *
- * @brief Atomic bitwise inclusive OR.
- *
- * This routine atomically sets @a target to the bitwise inclusive OR of
- * @a target and @a value.
- *
- * @note As for all atomic APIs, includes a
- * full/sequentially-consistent memory barrier (where applicable).
- *
- * @param target Address of atomic variable.
- * @param value Value to OR.
- *
- * @return Previous value of @a target.
+ * @return Core clock cycles, wraps every 2^32 cycles.
  */
-static inline atomic_t atomic_or(atomic_t *target, atomic_t value) {
-#ifdef __CM_CMSIS_VERSION
-    atomic_t prev_val;
-    do {
-        prev_val = __LDREXW((__IO uint32_t *)target);
-    } while ((__STREXW(prev_val | (value), (__IO uint32_t *)target)) != 0);
-    return prev_val;
-#else
-    return __atomic_fetch_or(target, value, __ATOMIC_SEQ_CST);
-#endif
+uint32_t k_cycle_get_32(void) {
+    if ((DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) == 0U) {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0U;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+    return DWT->CYCCNT;
 }
 
 /**
- * @brief Atomically set a bit.
- *
- * Atomically set bit number @a bit of @a target and return its old value.
- * The target may be a single atomic variable or an array of them.
- *
- * @note As for all atomic APIs, includes a
- * full/sequentially-consistent memory barrier (where applicable).
- *
- * @param target Address of atomic variable or array.
- * @param bit Bit number (starting from 0).
- *
- * @return true if the bit was set, false if it wasn't.
+ * @brief Rate of k_cycle_get_32(), the core clock.
  */
-bool atomic_test_and_set_bit(atomic_t *target, int bit) {
-    atomic_t old;
-    atomic_t mask = ATOMIC_MASK(bit);
-
-    old = atomic_or(ATOMIC_ELEM(target, bit), mask);
-
-    return (old & mask) != 0;
-}
+uint32_t k_cycle_hz(void) { return SystemCoreClock; }
 
 /**
- * @brief Atomically test and clear a bit.
- *
- * Atomically clear bit number @a bit of @a target and return its old value.
- * The target may be a single atomic variable or an array of them.
- *
- * @note As for all atomic APIs, includes a
- * full/sequentially-consistent memory barrier (where applicable).
+ * @brief Atomically re-enable interrupts and enter low-power wait.
  *
- * @param target Address of atomic variable or array.
- * @param bit Bit number (starting from 0).
+ * Must be called with interrupts disabled by k_interrupt_disable(). A
+ * pending interrupt still wakes WFI while PRIMASK is set, so an event
+ * arriving between the caller's last check and WFI is not lost.
  *
- * @return true if the bit was set, false if it wasn't.
+ * @param key Value returned by the matching k_interrupt_disable().
  */
-bool atomic_test_and_clear_bit(atomic_t *target, int bit) {
-    atomic_t old;
-    atomic_t mask = ATOMIC_MASK(bit);
-
-    old = atomic_and(ATOMIC_ELEM(target, bit), ~mask);
-
-    return (old & mask) != 0;
-}
-
-void atomic_clear_bit(atomic_t *target, int bit) {
-    atomic_t mask = ATOMIC_MASK(bit);
-    
-    (void)atomic_and(ATOMIC_ELEM(target, bit), ~mask);
-}
-
-void k_msleep(int32_t ms) {
-    HAL_Delay(ms);
+void k_cpu_atomic_idle(atomic_t key) {
+#ifdef K_CONFIG_IRQ_PROFILE
+    /* the region ends here, sleeping with a pending wakeup is not latency */
+    z_irq_prof_stop(key);
+#endif
+#ifdef K_CONFIG_IRQ_BASEPRI
+    /* an interrupt masked by BASEPRI does not wake WFI, hold them off with
+     * PRIMASK instead while waiting
+     */
+    __disable_irq();
+    __set_BASEPRI(0U);
+    __ISB();
+    __DSB();
+    __WFI();
+    __set_BASEPRI((uint32_t)key);
+    __enable_irq();
+#else
+    __DSB();
+    __WFI();
+    k_interrupt_enable(key);
+#endif
 }
 
 #ifdef K_CONFIG_TICKLESS_KERNEL
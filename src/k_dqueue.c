@@ -0,0 +1,151 @@
+/*
+ * @Date: 2026-10-20 15:08:44
+ * @FilePath: \Openy_Framework\src\k_dqueue.c
+ * @Description: Doubly-linked queue with O(1) removal
+ *
+ * Same usage as k_queue but items reserve a sys_dnode_t (two words)
+ * instead of one word, so an item can be unlinked from anywhere in the
+ * queue without walking it. Meant for queues whose items get cancelled.
+ * There are no alloc variants, the node must be embedded in the item.
+ */
+#include "k_kernel.h"
+
+#ifdef K_CONFIG_QUEUE
+
+void k_dqueue_init(k_dqueue_t *queue) {
+    queue->lock = (struct k_spinlock){0};
+    sys_dlist_init(&queue->data_q);
+    K_OBJ_STATS_INIT(&queue->stats, K_OBJ_STATS_QUEUE, 0);
+}
+
+/**
+ * @brief Insert an element after another one.
+ *
+ * @funcprops \isr_ok
+ *
+ * @param queue Address of the queue.
+ * @param prev Address of the previous data item, NULL to prepend.
+ * @param data Address of the data item.
+ */
+void k_dqueue_insert(k_dqueue_t *queue, void *prev, void *data) {
+    k_spinlock_key_t key = k_spin_lock(&queue->lock);
+    if (prev == NULL) {
+        sys_dlist_prepend(&queue->data_q, (sys_dnode_t *)data);
+    } else {
+        sys_dlist_insert(((sys_dnode_t *)prev)->next, (sys_dnode_t *)data);
+    }
+    K_OBJ_STATS_PUT(&queue->stats, K_OBJ_STATS_QUEUE, 1, 0, queue->stats.used + 1U, 0);
+    k_spin_unlock(&queue->lock, key);
+}
+
+/**
+ * @brief Append an element to the end of a queue.
+ *
+ * @funcprops \isr_ok
+ *
+ * @param queue Address of the queue.
+ * @param data Address of the data item.
+ */
+void k_dqueue_append(k_dqueue_t *queue, void *data) {
+    k_spinlock_key_t key = k_spin_lock(&queue->lock);
+    sys_dlist_append(&queue->data_q, (sys_dnode_t *)data);
+    K_OBJ_STATS_PUT(&queue->stats, K_OBJ_STATS_QUEUE, 1, 0, queue->stats.used + 1U, 0);
+    k_spin_unlock(&queue->lock, key);
+}
+
+/**
+ * @brief Prepend an element to a queue.
+ *
+ * @funcprops \isr_ok
+ *
+ * @param queue Address of the queue.
+ * @param data Address of the data item.
+ */
+void k_dqueue_prepend(k_dqueue_t *queue, void *data) {
+    k_spinlock_key_t key = k_spin_lock(&queue->lock);
+    sys_dlist_prepend(&queue->data_q, (sys_dnode_t *)data);
+    K_OBJ_STATS_PUT(&queue->stats, K_OBJ_STATS_QUEUE, 1, 0, queue->stats.used + 1U, 0);
+    k_spin_unlock(&queue->lock, key);
+}
+
+/**
+ * @brief Get an element from a queue.
+ *
+ * @funcprops \isr_ok
+ *
+ * @param queue Address of the queue.
+ *
+ * @return Address of the data item, NULL if the queue is empty.
+ */
+void *k_dqueue_get(k_dqueue_t *queue) {
+    sys_dnode_t *node;
+
+    k_spinlock_key_t key = k_spin_lock(&queue->lock);
+    node = sys_dlist_get(&queue->data_q);
+    if (node != NULL) {
+        K_OBJ_STATS_GET(&queue->stats, 1, queue->stats.used - 1U);
+    }
+    k_spin_unlock(&queue->lock, key);
+
+    return node;
+}
+
+/**
+ * @brief Remove an element from a queue in constant time.
+ *
+ * The item must be on @a queue or have been taken off it by a get or a
+ * remove, so cancelling an item the consumer already got is harmless.
+ *
+ * @funcprops \isr_ok
+ *
+ * @param queue Address of the queue.
+ * @param data Address of the data item.
+ *
+ * @return true if data item was removed
+ */
+bool k_dqueue_remove(k_dqueue_t *queue, void *data) {
+    sys_dnode_t *node = (sys_dnode_t *)data;
+    bool ret = false;
+
+    k_spinlock_key_t key = k_spin_lock(&queue->lock);
+    if (sys_dnode_is_linked(node)) {
+        sys_dlist_remove(node);
+        K_OBJ_STATS_GET(&queue->stats, 1, queue->stats.used - 1U);
+        ret = true;
+    }
+    k_spin_unlock(&queue->lock, key);
+
+    return ret;
+}
+
+/**
+ * @brief Query a queue to see if it has data available.
+ *
+ * @funcprops \isr_ok
+ *
+ * @param queue Address of the queue.
+ *
+ * @return Non-zero if the queue is empty.
+ * @return 0 if data is available.
+ */
+int k_dqueue_is_empty(k_dqueue_t *queue) { return (int)sys_dlist_is_empty(&queue->data_q); }
+
+/**
+ * @brief Peek element at the head of queue.
+ *
+ * @param queue Address of the queue.
+ *
+ * @return Head element, or NULL if queue is empty.
+ */
+void *k_dqueue_peek_head(k_dqueue_t *queue) { return sys_dlist_peek_head(&queue->data_q); }
+
+/**
+ * @brief Peek element at the tail of queue.
+ *
+ * @param queue Address of the queue.
+ *
+ * @return Tail element, or NULL if queue is empty.
+ */
+void *k_dqueue_peek_tail(k_dqueue_t *queue) { return sys_dlist_peek_tail(&queue->data_q); }
+
+#endif // K_CONFIG_QUEUE
@@ -0,0 +1,441 @@
+/*
+ * @Date: 2026-10-20 11:26:50
+ * @FilePath: \Openy_Framework\src\k_heap.c
+ * @Description: Two-Level Segregated Fit heap
+ *
+ * Free blocks are kept in size classes indexed by the position of the
+ * size's most significant bit (first level) and the next
+ * K_HEAP_SL_INDEX_COUNT_LOG2 bits (second level). Two bitmaps record the
+ * non-empty classes, so finding a fitting block is a couple of
+ * count-leading/trailing-zeros and alloc/free run in bounded time whatever
+ * the heap state. Neighbouring free blocks are merged immediately.
+ *
+ * Block layout: the header is the size word, the previous-block pointer
+ * lives in the last word of the previous block and is valid only while
+ * that block is free, as are the free list links stored in the payload.
+ */
+#include "k_kernel.h"
+
+#ifdef K_CONFIG_HEAP
+
+struct z_heap_block {
+    /** Previous physical block, only valid if it is free */
+    struct z_heap_block *prev_phys;
+    /** Payload size, bit 0: this block is free, bit 1: previous block is free */
+    size_t size;
+    /** Free list links, only valid if this block is free */
+    struct z_heap_block *next_free;
+    struct z_heap_block *prev_free;
+};
+
+#define BLOCK_FREE_BIT      ((size_t)1U)
+#define BLOCK_PREV_FREE_BIT ((size_t)2U)
+
+#define BLOCK_OVERHEAD      sizeof(size_t)
+#define BLOCK_START_OFFSET  (offsetof(struct z_heap_block, size) + sizeof(size_t))
+#define BLOCK_SIZE_MIN      (sizeof(struct z_heap_block) - sizeof(struct z_heap_block *))
+#define BLOCK_SIZE_MAX      ((size_t)1U << K_CONFIG_HEAP_FL_INDEX_MAX)
+#define SMALL_BLOCK_SIZE    ((size_t)1U << K_HEAP_FL_INDEX_SHIFT)
+
+#define ALIGN_UP(x)   (((x) + (K_HEAP_ALIGN_SIZE - 1U)) & ~(size_t)(K_HEAP_ALIGN_SIZE - 1U))
+#define ALIGN_DOWN(x) ((x) & ~(size_t)(K_HEAP_ALIGN_SIZE - 1U))
+
+static inline int heap_fls(size_t x) {
+    return (int)(sizeof(unsigned long) * 8U) - 1 - __builtin_clzl((unsigned long)x);
+}
+
+static inline size_t block_size(const struct z_heap_block *block) {
+    return block->size & ~(BLOCK_FREE_BIT | BLOCK_PREV_FREE_BIT);
+}
+
+static inline void block_set_size(struct z_heap_block *block, size_t size) {
+    block->size = size | (block->size & (BLOCK_FREE_BIT | BLOCK_PREV_FREE_BIT));
+}
+
+static inline bool block_is_free(const struct z_heap_block *block) {
+    return (block->size & BLOCK_FREE_BIT) != 0U;
+}
+
+static inline bool block_is_prev_free(const struct z_heap_block *block) {
+    return (block->size & BLOCK_PREV_FREE_BIT) != 0U;
+}
+
+static inline bool block_is_last(const struct z_heap_block *block) { return block_size(block) == 0U; }
+
+static inline void *block_to_ptr(struct z_heap_block *block) {
+    return (char *)block + BLOCK_START_OFFSET;
+}
+
+static inline struct z_heap_block *block_from_ptr(void *ptr) {
+    return (struct z_heap_block *)((char *)ptr - BLOCK_START_OFFSET);
+}
+
+static inline struct z_heap_block *block_next(struct z_heap_block *block) {
+    return (struct z_heap_block *)((char *)block_to_ptr(block) + block_size(block) - BLOCK_OVERHEAD);
+}
+
+/* Point the next block back at @a block and return it */
+static inline struct z_heap_block *block_link_next(struct z_heap_block *block) {
+    struct z_heap_block *next = block_next(block);
+
+    next->prev_phys = block;
+    return next;
+}
+
+static inline void block_mark_free(struct z_heap_block *block) {
+    struct z_heap_block *next = block_link_next(block);
+
+    next->size |= BLOCK_PREV_FREE_BIT;
+    block->size |= BLOCK_FREE_BIT;
+}
+
+static inline void block_mark_used(struct z_heap_block *block) {
+    struct z_heap_block *next = block_next(block);
+
+    next->size &= ~BLOCK_PREV_FREE_BIT;
+    block->size &= ~BLOCK_FREE_BIT;
+}
+
+/* Size class a block of @a size is filed under */
+static inline void mapping_insert(size_t size, int *fl, int *sl) {
+    if (size < SMALL_BLOCK_SIZE) {
+        *fl = 0;
+        *sl = (int)(size / (SMALL_BLOCK_SIZE / K_HEAP_SL_INDEX_COUNT));
+    } else {
+        int f = heap_fls(size);
+
+        *sl = (int)(size >> (f - K_HEAP_SL_INDEX_COUNT_LOG2)) ^ K_HEAP_SL_INDEX_COUNT;
+        *fl = f - (K_HEAP_FL_INDEX_SHIFT - 1);
+    }
+}
+
+/* Size class whose every block is at least @a size: round up to the next
+ * class so that the head of any list found is a fit, no list walk needed
+ */
+static inline void mapping_search(size_t size, int *fl, int *sl) {
+    if (size >= SMALL_BLOCK_SIZE) {
+        size += ((size_t)1U << (heap_fls(size) - K_HEAP_SL_INDEX_COUNT_LOG2)) - 1U;
+    }
+    mapping_insert(size, fl, sl);
+}
+
+static struct z_heap_block *search_suitable_block(k_heap_t *heap, int *fl, int *sl) {
+    uint32_t sl_map = heap->sl_bitmap[*fl] & (~0UL << *sl);
+
+    if (sl_map == 0U) {
+        uint32_t fl_map = (*fl + 1 < 32) ? (heap->fl_bitmap & (~0UL << (*fl + 1))) : 0U;
+
+        if (fl_map == 0U) {
+            return NULL;
+        }
+        *fl = __builtin_ctz(fl_map);
+        sl_map = heap->sl_bitmap[*fl];
+    }
+    *sl = __builtin_ctz(sl_map);
+
+    return heap->blocks[*fl][*sl];
+}
+
+static void remove_free_block(k_heap_t *heap, struct z_heap_block *block, int fl, int sl) {
+    struct z_heap_block *prev = block->prev_free;
+    struct z_heap_block *next = block->next_free;
+
+    if (next != NULL) {
+        next->prev_free = prev;
+    }
+    if (prev != NULL) {
+        prev->next_free = next;
+    } else {
+        heap->blocks[fl][sl] = next;
+        if (next == NULL) {
+            heap->sl_bitmap[fl] &= ~BIT(sl);
+            if (heap->sl_bitmap[fl] == 0U) {
+                heap->fl_bitmap &= ~BIT(fl);
+            }
+        }
+    }
+}
+
+static void insert_free_block(k_heap_t *heap, struct z_heap_block *block, int fl, int sl) {
+    struct z_heap_block *current = heap->blocks[fl][sl];
+
+    block->next_free = current;
+    block->prev_free = NULL;
+    if (current != NULL) {
+        current->prev_free = block;
+    }
+    heap->blocks[fl][sl] = block;
+    heap->fl_bitmap |= BIT(fl);
+    heap->sl_bitmap[fl] |= BIT(sl);
+}
+
+static inline void block_remove(k_heap_t *heap, struct z_heap_block *block) {
+    int fl, sl;
+
+    mapping_insert(block_size(block), &fl, &sl);
+    remove_free_block(heap, block, fl, sl);
+}
+
+static inline void block_insert(k_heap_t *heap, struct z_heap_block *block) {
+    int fl, sl;
+
+    mapping_insert(block_size(block), &fl, &sl);
+    insert_free_block(heap, block, fl, sl);
+}
+
+/* Cut @a block down to @a size and return the free remainder */
+static struct z_heap_block *block_split(struct z_heap_block *block, size_t size) {
+    struct z_heap_block *remaining =
+        (struct z_heap_block *)((char *)block_to_ptr(block) + size - BLOCK_OVERHEAD);
+    size_t remain_size = block_size(block) - (size + BLOCK_OVERHEAD);
+
+    remaining->size = remain_size;
+    block_set_size(block, size);
+    block_mark_free(remaining);
+
+    return remaining;
+}
+
+/* Merge @a block into the physically preceding free block @a prev */
+static struct z_heap_block *block_absorb(struct z_heap_block *prev, struct z_heap_block *block) {
+    prev->size += block_size(block) + BLOCK_OVERHEAD;
+    (void)block_link_next(prev);
+    return prev;
+}
+
+static int heap_setup(k_heap_t *heap) {
+    struct z_heap_block *block, *next;
+    size_t pool_bytes;
+
+    if (((uintptr_t)heap->mem % K_HEAP_ALIGN_SIZE) != 0U ||
+        heap->mem_size < 2U * BLOCK_OVERHEAD + BLOCK_SIZE_MIN) {
+        return -EINVAL;
+    }
+    pool_bytes = ALIGN_DOWN(heap->mem_size - 2U * BLOCK_OVERHEAD);
+    if (pool_bytes >= BLOCK_SIZE_MAX) {
+        pool_bytes = BLOCK_SIZE_MAX - K_HEAP_ALIGN_SIZE;
+    }
+
+    heap->fl_bitmap = 0;
+    for (int i = 0; i < K_HEAP_FL_INDEX_COUNT; i++) {
+        heap->sl_bitmap[i] = 0;
+        for (int j = 0; j < K_HEAP_SL_INDEX_COUNT; j++) {
+            heap->blocks[i][j] = NULL;
+        }
+    }
+
+    /* the first block's prev_phys would lie before the pool, it is never
+     * read since the previous-free bit stays clear
+     */
+    block = (struct z_heap_block *)((char *)heap->mem - BLOCK_OVERHEAD);
+    block->size = pool_bytes | BLOCK_FREE_BIT;
+    block_insert(heap, block);
+
+    /* zero-sized, used sentinel stops merging at the end of the pool */
+    next = block_link_next(block);
+    next->size = BLOCK_PREV_FREE_BIT;
+
+    heap->allocated_bytes = 0;
+    heap->max_allocated_bytes = 0;
+    heap->alloc_fails = 0;
+    heap->ready = true;
+
+    return 0;
+}
+
+/**
+ * @brief Initialize a heap.
+ *
+ * Independent heaps do not share any state, e.g. one per subsystem keeps
+ * fragmentation in one from starving the others.
+ *
+ * @param heap Address of the heap.
+ * @param mem Heap memory, aligned on a pointer boundary.
+ * @param bytes Size of @a mem, bytes beyond 2^K_CONFIG_HEAP_FL_INDEX_MAX
+ *        are not used.
+ *
+ * @retval 0 on success
+ * @retval -EINVAL @a mem is misaligned or too small
+ */
+int k_heap_init(k_heap_t *heap, void *mem, size_t bytes) {
+    heap->mem = mem;
+    heap->mem_size = bytes;
+    heap->ready = false;
+    heap->lock = (struct k_spinlock){0};
+
+    return heap_setup(heap);
+}
+
+/**
+ * @brief Allocate memory from a heap.
+ *
+ * Good-fit: the request is rounded up to the next size class so the first
+ * block found always fits. Bounded time, usable from ISRs.
+ *
+ * @funcprops \isr_ok
+ *
+ * @param heap Address of the heap.
+ * @param bytes Requested size.
+ *
+ * @return Pointer aligned on K_HEAP_ALIGN_SIZE, or NULL if no block fits.
+ */
+void *k_heap_alloc(k_heap_t *heap, size_t bytes) {
+    struct z_heap_block *block = NULL;
+    size_t size;
+    int fl, sl;
+
+    if (bytes == 0U || bytes > BLOCK_SIZE_MAX) {
+        return NULL;
+    }
+    size = MAX(ALIGN_UP(bytes), BLOCK_SIZE_MIN);
+
+    /* lock */
+    k_spinlock_key_t key = k_spin_lock(&heap->lock);
+
+    if (!heap->ready && heap_setup(heap) != 0) {
+        k_spin_unlock(&heap->lock, key);
+        return NULL;
+    }
+
+    mapping_search(size, &fl, &sl);
+    if (fl < K_HEAP_FL_INDEX_COUNT) {
+        block = search_suitable_block(heap, &fl, &sl);
+    }
+
+    if (block != NULL) {
+        remove_free_block(heap, block, fl, sl);
+
+        /* give back the tail if it can hold a block of its own */
+        if (block_size(block) >= size + sizeof(struct z_heap_block)) {
+            block_insert(heap, block_split(block, size));
+        }
+        block_mark_used(block);
+
+        heap->allocated_bytes += block_size(block);
+        if (heap->allocated_bytes > heap->max_allocated_bytes) {
+            heap->max_allocated_bytes = heap->allocated_bytes;
+        }
+    } else {
+        heap->alloc_fails++;
+    }
+
+    /* unlock */
+    k_spin_unlock(&heap->lock, key);
+
+    return (block != NULL) ? block_to_ptr(block) : NULL;
+}
+
+/**
+ * @brief Free memory allocated by k_heap_alloc().
+ *
+ * @funcprops \isr_ok
+ *
+ * @param heap Address of the heap.
+ * @param mem Memory to free, NULL is ignored.
+ */
+void k_heap_free(k_heap_t *heap, void *mem) {
+    struct z_heap_block *block, *next;
+
+    if (mem == NULL) {
+        return;
+    }
+    block = block_from_ptr(mem);
+    __ASSERT(!block_is_free(block), "double free of %p", mem);
+
+    /* lock */
+    k_spinlock_key_t key = k_spin_lock(&heap->lock);
+
+    heap->allocated_bytes -= block_size(block);
+    block_mark_free(block);
+
+    if (block_is_prev_free(block)) {
+        struct z_heap_block *prev = block->prev_phys;
+
+        block_remove(heap, prev);
+        block = block_absorb(prev, block);
+    }
+
+    next = block_next(block);
+    if (block_is_free(next)) {
+        block_remove(heap, next);
+        block = block_absorb(block, next);
+    }
+
+    block_insert(heap, block);
+
+    /* unlock */
+    k_spin_unlock(&heap->lock, key);
+}
+
+/**
+ * @brief Snapshot usage and fragmentation of a heap.
+ *
+ * Walks every block with the heap locked, so the cost grows with the
+ * number of blocks: meant for diagnostics, not for the fast path.
+ *
+ * @param heap Address of the heap.
+ * @param stats Area to store the snapshot.
+ */
+void k_heap_stats_get(k_heap_t *heap, struct k_heap_stats *stats) {
+    struct z_heap_block *block;
+
+    stats->free_bytes = 0;
+    stats->largest_free = 0;
+    stats->free_blocks = 0;
+
+    /* lock */
+    k_spinlock_key_t key = k_spin_lock(&heap->lock);
+
+    if (!heap->ready) {
+        (void)heap_setup(heap);
+    }
+
+    if (heap->ready) {
+        block = (struct z_heap_block *)((char *)heap->mem - BLOCK_OVERHEAD);
+        for (; !block_is_last(block); block = block_next(block)) {
+            if (block_is_free(block)) {
+                stats->free_bytes += block_size(block);
+                stats->largest_free = MAX(stats->largest_free, block_size(block));
+                stats->free_blocks++;
+            }
+        }
+    }
+    stats->allocated_bytes = heap->allocated_bytes;
+    stats->max_allocated_bytes = heap->max_allocated_bytes;
+    stats->alloc_fails = heap->alloc_fails;
+
+    /* unlock */
+    k_spin_unlock(&heap->lock, key);
+
+    /* requests are rounded up to a size class, a free block only serves
+     * those up to the lower bound of its own class
+     */
+    if (stats->largest_free >= SMALL_BLOCK_SIZE) {
+        int f = heap_fls(stats->largest_free) - K_HEAP_SL_INDEX_COUNT_LOG2;
+
+        stats->largest_free = (stats->largest_free >> f) << f;
+    }
+
+    stats->fragmentation =
+        (stats->free_bytes != 0U)
+            ? (uint8_t)(100U - (uint32_t)((uint64_t)stats->largest_free * 100U / stats->free_bytes))
+            : 0U;
+}
+
+void k_heap_runtime_stats_reset_max(k_heap_t *heap) {
+    k_spinlock_key_t key = k_spin_lock(&heap->lock);
+    heap->max_allocated_bytes = heap->allocated_bytes;
+    k_spin_unlock(&heap->lock, key);
+}
+
+#ifdef K_CONFIG_HEAP_MALLOC
+
+K_HEAP_DEFINE(z_malloc_heap, K_CONFIG_HEAP_MALLOC_SIZE);
+
+void *k_malloc(size_t size) { return k_heap_alloc(&z_malloc_heap, size); }
+
+void k_free(void *ptr) { k_heap_free(&z_malloc_heap, ptr); }
+
+#endif // K_CONFIG_HEAP_MALLOC
+
+#endif // K_CONFIG_HEAP
@@ -174,6 +174,9 @@ static void hsm_dispatch(k_asm_t *const me, k_mevt_t const *const e) {
     k_stateHandler_t s = me->state;
     k_stateHandler_t t = s;
 
+    K_TRACE_HSM_DISPATCH(me, e->sig);
+    K_LOAD_ENTER(load, K_LOAD_HSM);
+
     // process the event hierarchically...
     k_state r;
     me->temp = s;
@@ -195,6 +198,7 @@ static void hsm_dispatch(k_asm_t *const me, k_mevt_t const *const e) {
         path[0] = me->temp; // tran. target
         path[1] = t;        // current state
         path[2] = s;        // tran. source
+        K_TRACE_HSM_TRAN(me, path[0]);
 
         // exit current state to tran. source s...
         limit = K_HSM_MAX_NEST_DEPTH; // loop hard limit
@@ -246,6 +250,8 @@ static void hsm_dispatch(k_asm_t *const me, k_mevt_t const *const e) {
     }
 
     me->state = t; // change the current active state
+    K_LOAD_EXIT(load);
+    K_TRACE_HSM_DISPATCH_END(me);
 }
 
 static bool hsm_isIn(k_asm_t *const me, k_stateHandler_t const state) {
@@ -287,7 +293,7 @@ bool k_mevt_post(k_hsm_t *const me, k_mevt_t const *const e) {
 
     uint_fast16_t nFree = me->eQueue.max_msgs - me->eQueue.used_msgs;
 
-    bool status;
+    bool status = false;
 
     if (nFree > 0) { // can post the event?
         int err = k_msgq_put(&me->eQueue, (void const *)&e);
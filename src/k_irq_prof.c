@@ -0,0 +1,163 @@
+/*
+ * @Date: 2026-10-20 17:02:37
+ * @FilePath: \Openy_Framework\src\k_irq_prof.c
+ * @Description: Critical section duration profiler
+ *
+ * Only the outermost region is timed: nested disables see a non-zero key
+ * and are part of the enclosing region. With interrupts masked at most one
+ * outermost region is open per core, so each core keeps its open site and
+ * start in its own slot; the site table is shared and takes a spinlock.
+ * The bookkeeping runs after the end timestamp but before unmasking, it
+ * lengthens the real masked time slightly without being counted.
+ */
+#include "k_kernel.h"
+
+#ifdef K_CONFIG_IRQ_PROFILE
+
+/* the profiler masks with the primitives, it must not profile itself */
+#undef k_interrupt_disable
+#undef k_interrupt_enable
+
+/* Outermost region open on one core */
+struct prof_open {
+    const char *file;
+    int line;
+    uint32_t start;
+};
+
+static struct k_irq_prof_site sSites[K_CONFIG_IRQ_PROFILE_SITES];
+static struct prof_open sOpen[Z_NUM_CPUS];
+static struct k_spinlock sSitesLock;
+
+/* Callers have interrupts masked already, so only the lock word is taken:
+ * k_spin_unlock() would re-enter the profiler through k_interrupt_enable()
+ */
+static inline void prof_sites_lock(void) { (void)z_spin_lock(&sSitesLock, 0); }
+
+static inline void prof_sites_unlock(void) {
+#ifdef K_CONFIG_SMP
+    (void)atomic_clear(&sSitesLock.locked);
+#endif
+}
+
+/* Entry of a call site, called with sSitesLock held */
+static struct k_irq_prof_site *prof_site(const char *file, int line) {
+    struct k_irq_prof_site *site;
+
+    /* __FILE__ of one site is always the same literal, no strcmp needed */
+    for (site = sSites; site < &sSites[K_CONFIG_IRQ_PROFILE_SITES - 1]; site++) {
+        if (site->file == NULL) {
+            site->file = file;
+            site->line = line;
+            return site;
+        }
+        if (site->line == line && site->file == file) {
+            return site;
+        }
+    }
+
+    site->file = "other";
+    site->line = 0;
+    return site;
+}
+
+atomic_t z_irq_prof_disable(const char *file, int line) {
+    atomic_t key = k_interrupt_disable();
+
+    if (key == 0) {
+        struct prof_open *open = &sOpen[k_cpu_id()];
+
+        open->file = file;
+        open->line = line;
+        open->start = k_cycle_get_32();
+    }
+    return key;
+}
+
+/**
+ * @brief Close the region opened by the outermost disable, if @a key ends it.
+ */
+void z_irq_prof_stop(atomic_t key) {
+    struct prof_open *open = &sOpen[k_cpu_id()];
+    struct k_irq_prof_site *site;
+    uint32_t cycles;
+
+    if (key != 0 || open->file == NULL) {
+        return;
+    }
+    cycles = k_cycle_get_32() - open->start;
+
+    prof_sites_lock();
+    site = prof_site(open->file, open->line);
+    site->count++;
+    site->total_cycles += cycles;
+    if (cycles > site->max_cycles) {
+        site->max_cycles = cycles;
+    }
+    prof_sites_unlock();
+    open->file = NULL;
+}
+
+void z_irq_prof_enable(atomic_t key) {
+    z_irq_prof_stop(key);
+    k_interrupt_enable(key);
+}
+
+/**
+ * @brief Copy the call site entry @a index.
+ *
+ * @retval 0 on success
+ * @retval -EINVAL @a index is out of range or not used yet
+ */
+int k_irq_prof_site_get(int index, struct k_irq_prof_site *site) {
+    int err = -EINVAL;
+
+    if (index >= 0 && index < K_CONFIG_IRQ_PROFILE_SITES) {
+        atomic_t key = k_interrupt_disable();
+        prof_sites_lock();
+        if (sSites[index].file != NULL) {
+            *site = sSites[index];
+            err = 0;
+        }
+        prof_sites_unlock();
+        k_interrupt_enable(key);
+    }
+    return err;
+}
+
+void k_irq_prof_reset(void) {
+    atomic_t key = k_interrupt_disable();
+    prof_sites_lock();
+    memset(sSites, 0, sizeof(sSites));
+    prof_sites_unlock();
+    k_interrupt_enable(key);
+}
+
+/**
+ * @brief Print every call site, worst case first.
+ */
+void k_irq_prof_dump(void) {
+    static struct k_irq_prof_site sorted[K_CONFIG_IRQ_PROFILE_SITES];
+    struct k_irq_prof_site site;
+    int n = 0;
+
+    /* insertion sort on max_cycles, the table is small */
+    while (k_irq_prof_site_get(n, &site) == 0) {
+        int i = n++;
+
+        while (i > 0 && sorted[i - 1].max_cycles < site.max_cycles) {
+            sorted[i] = sorted[i - 1];
+            i--;
+        }
+        sorted[i] = site;
+    }
+
+    K_LOG_INFO("irq masked, cycles: max avg count site");
+    for (int i = 0; i < n; i++) {
+        K_LOG_INFO("  %u %u %u %s:%d", (unsigned int)sorted[i].max_cycles,
+                   (unsigned int)(sorted[i].total_cycles / sorted[i].count),
+                   (unsigned int)sorted[i].count, sorted[i].file, sorted[i].line);
+    }
+}
+
+#endif // K_CONFIG_IRQ_PROFILE
@@ -0,0 +1,124 @@
+/*
+ * @Date: 2026-10-20 16:21:05
+ * @FilePath: \Openy_Framework\src\k_lifo.c
+ * @Description: Lock-free intrusive LIFO (Treiber stack)
+ *
+ * Push and pop are a single atomic_cas() on the head, retried if another
+ * context got in between, interrupts are never masked.
+ *
+ * A plain pointer head would suffer from ABA: a pop reads top A and its
+ * successor B, gets preempted while A and B are popped and A is pushed
+ * back, then its CAS still sees A and installs the stale B. The head
+ * therefore packs a tag bumped by every operation next to the top node.
+ * To fit both in one atomic_t the node is stored as a word index into the
+ * region given at init (16 bits of index and 16 bits of tag on a 32-bit
+ * target, i.e. up to 256 KB of nodes), which only needs the single-word
+ * exclusive access every Cortex-M with LDREX/STREX has.
+ */
+#include "k_kernel.h"
+
+#ifdef K_CONFIG_LIFO
+
+#define LIFO_HALF_BITS (sizeof(atomic_t) * 4U)
+#define LIFO_IDX_MASK  ((1UL << LIFO_HALF_BITS) - 1UL)
+
+static inline unsigned long lifo_idx(const k_lifo_t *lifo, void *node) {
+    __ASSERT((char *)node >= lifo->base &&
+                 (char *)node < lifo->base + lifo->max_idx * sizeof(void *) &&
+                 (((char *)node - lifo->base) % sizeof(void *)) == 0U,
+             "node %p outside lifo %p region", node, lifo);
+
+    return (unsigned long)(((char *)node - lifo->base) / sizeof(void *)) + 1UL;
+}
+
+static inline void *lifo_node(const k_lifo_t *lifo, unsigned long idx) {
+    return lifo->base + (idx - 1UL) * sizeof(void *);
+}
+
+/* Head value replacing @a old, with the tag bumped and @a idx on top */
+static inline atomic_t lifo_head_next(atomic_t old, unsigned long idx) {
+    unsigned long tag = ((unsigned long)old >> LIFO_HALF_BITS) + 1UL;
+
+    return (atomic_t)((tag << LIFO_HALF_BITS) | idx);
+}
+
+/**
+ * @brief Initialize a LIFO.
+ *
+ * @param lifo Address of the LIFO.
+ * @param region Start of the memory all pushed nodes belong to, pointer
+ *        aligned (a pool, or the whole RAM).
+ * @param region_size Size of @a region, at most 2^16 words on a 32-bit
+ *        target.
+ *
+ * @retval 0 on success
+ * @retval -EINVAL @a region is misaligned or too large
+ */
+int k_lifo_init(k_lifo_t *lifo, void *region, size_t region_size) {
+    if (((uintptr_t)region % sizeof(void *)) != 0U ||
+        region_size / sizeof(void *) >= LIFO_IDX_MASK) {
+        return -EINVAL;
+    }
+
+    lifo->base = (char *)region;
+    lifo->max_idx = (uint32_t)(region_size / sizeof(void *));
+    (void)atomic_set(&lifo->head, 0);
+
+    return 0;
+}
+
+/**
+ * @brief Push a node.
+ *
+ * The first word of the node is reserved for the link.
+ *
+ * @funcprops \isr_ok
+ *
+ * @param lifo Address of the LIFO.
+ * @param node Address of the node, inside the LIFO region.
+ */
+void k_lifo_push(k_lifo_t *lifo, void *node) {
+    unsigned long idx = lifo_idx(lifo, node);
+    atomic_t old;
+
+    do {
+        old = atomic_get(&lifo->head);
+        *(volatile uintptr_t *)node = (uintptr_t)((unsigned long)old & LIFO_IDX_MASK);
+    } while (!atomic_cas(&lifo->head, old, lifo_head_next(old, idx)));
+}
+
+/**
+ * @brief Pop the most recently pushed node.
+ *
+ * @funcprops \isr_ok
+ *
+ * @param lifo Address of the LIFO.
+ *
+ * @return Address of the node, NULL if the LIFO is empty.
+ */
+void *k_lifo_pop(k_lifo_t *lifo) {
+    unsigned long idx, next;
+    atomic_t old;
+    void *node;
+
+    do {
+        old = atomic_get(&lifo->head);
+        idx = (unsigned long)old & LIFO_IDX_MASK;
+        if (idx == 0UL) {
+            return NULL;
+        }
+        node = lifo_node(lifo, idx);
+        /* may read a link rewritten by a concurrent pop/push of the same
+         * node, the tag then makes the CAS fail and the value is dropped
+         */
+        next = (unsigned long)*(volatile uintptr_t *)node;
+    } while (!atomic_cas(&lifo->head, old, lifo_head_next(old, next & LIFO_IDX_MASK)));
+
+    return node;
+}
+
+bool k_lifo_is_empty(k_lifo_t *lifo) {
+    return ((unsigned long)atomic_get(&lifo->head) & LIFO_IDX_MASK) == 0UL;
+}
+
+#endif // K_CONFIG_LIFO
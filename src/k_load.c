@@ -0,0 +1,167 @@
+/*
+ * @Date: 2026-10-20 21:08:12
+ * @FilePath: \Openy_Framework\src\k_load.c
+ * @Description: CPU load measurement
+ *
+ * Each core keeps the activity it is running and the cycle stamp of the
+ * last switch. A switch charges the elapsed cycles to the outgoing
+ * activity, so an ISR preempting a handler is taken out of the handler's
+ * time rather than counted twice. The sampling timeout lives on the core
+ * it measures.
+ */
+#include "k_kernel.h"
+
+#ifdef K_CONFIG_LOAD
+
+struct load_cpu {
+    uint8_t cur;
+    uint8_t hist_idx;
+    uint8_t hist_len;
+    uint32_t last;
+    /** Cycles of the current second */
+    uint32_t acc[K_LOAD_NUM];
+    uint32_t hist[K_CONFIG_LOAD_HISTORY][K_LOAD_NUM];
+    struct _timeout timeout;
+};
+
+static struct load_cpu sLoad[Z_NUM_CPUS];
+
+/* Charge the cycles since the last switch, called with interrupts masked */
+static inline void load_charge(struct load_cpu *lc) {
+    uint32_t now = k_cycle_get_32();
+
+    lc->acc[lc->cur] += now - lc->last;
+    lc->last = now;
+}
+
+/**
+ * @brief Make @a cat the running activity of the calling core.
+ *
+ * @return The previous activity, to switch back to.
+ */
+uint8_t z_load_switch(uint8_t cat) {
+    struct load_cpu *lc = &sLoad[k_cpu_id()];
+    atomic_t key = k_interrupt_disable();
+    uint8_t prev = lc->cur;
+
+    load_charge(lc);
+    lc->cur = cat;
+    k_interrupt_enable(key);
+
+    return prev;
+}
+
+static void load_sample(struct _timeout *to) {
+    struct load_cpu *lc = CONTAINER_OF(to, struct load_cpu, timeout);
+    atomic_t key = k_interrupt_disable();
+
+    load_charge(lc);
+    (void)memcpy(lc->hist[lc->hist_idx], lc->acc, sizeof(lc->acc));
+    (void)memset(lc->acc, 0, sizeof(lc->acc));
+    lc->hist_idx = (uint8_t)((lc->hist_idx + 1U) % K_CONFIG_LOAD_HISTORY);
+    if (lc->hist_len < K_CONFIG_LOAD_HISTORY) {
+        lc->hist_len++;
+    }
+    k_interrupt_enable(key);
+
+    k_timeout_add(&lc->timeout, load_sample, K_SECONDS(1));
+}
+
+/**
+ * @brief Start measuring the calling core, once per core.
+ */
+void k_load_init(void) {
+    struct load_cpu *lc = &sLoad[k_cpu_id()];
+    atomic_t key = k_interrupt_disable();
+
+    (void)memset(lc->acc, 0, sizeof(lc->acc));
+    lc->hist_idx = 0;
+    lc->hist_len = 0;
+    lc->cur = K_LOAD_OTHER;
+    lc->last = k_cycle_get_32();
+    k_interrupt_enable(key);
+
+    (void)k_timeout_abort(&lc->timeout);
+    k_timeout_add(&lc->timeout, load_sample, K_SECONDS(1));
+}
+
+/**
+ * @brief Cycles per activity over the last @a seconds.
+ *
+ * @param cpu Core to report.
+ * @param seconds Window, 1 to K_CONFIG_LOAD_HISTORY.
+ * @param stats Filled with the sums of the last complete seconds.
+ *
+ * @retval 0 on success
+ * @retval -EINVAL bad core or window
+ */
+int k_load_get(int cpu, uint32_t seconds, struct k_load_stats *stats) {
+    struct load_cpu *lc;
+    atomic_t key;
+    uint32_t idx;
+
+    if (cpu < 0 || cpu >= Z_NUM_CPUS || seconds == 0U || seconds > K_CONFIG_LOAD_HISTORY) {
+        return -EINVAL;
+    }
+    lc = &sLoad[cpu];
+    (void)memset(stats, 0, sizeof(*stats));
+
+    key = k_interrupt_disable();
+    stats->seconds = MIN(seconds, (uint32_t)lc->hist_len);
+    idx = lc->hist_idx;
+    for (uint32_t n = 0; n < stats->seconds; n++) {
+        idx = (idx + K_CONFIG_LOAD_HISTORY - 1U) % K_CONFIG_LOAD_HISTORY;
+        for (int c = 0; c < K_LOAD_NUM; c++) {
+            stats->cycles[c] += lc->hist[idx][c];
+        }
+    }
+    k_interrupt_enable(key);
+
+    for (int c = 0; c < K_LOAD_NUM; c++) {
+        stats->total_cycles += stats->cycles[c];
+    }
+    return 0;
+}
+
+/**
+ * @brief Busy share of @a cpu over the last @a seconds.
+ *
+ * @return Non-idle cycles in per mille, 0 if nothing was sampled yet.
+ */
+uint32_t k_load_permille(int cpu, uint32_t seconds) {
+    struct k_load_stats stats;
+
+    if (k_load_get(cpu, seconds, &stats) != 0 || stats.total_cycles == 0U) {
+        return 0;
+    }
+    return (uint32_t)(1000U - stats.cycles[K_LOAD_IDLE] * 1000U / stats.total_cycles);
+}
+
+static inline unsigned int load_pm(const struct k_load_stats *stats, int cat) {
+    return (unsigned int)(stats->cycles[cat] * 1000U / stats->total_cycles);
+}
+
+/**
+ * @brief Print the 1s/10s/60s load and its split for every core.
+ */
+void k_load_dump(void) {
+    static const uint32_t windows[] = {1, 10, 60};
+    struct k_load_stats stats;
+
+    for (int cpu = 0; cpu < Z_NUM_CPUS; cpu++) {
+        for (uint32_t w = 0; w < ARRAY_SIZE(windows); w++) {
+            if (k_load_get(cpu, MIN(windows[w], K_CONFIG_LOAD_HISTORY), &stats) != 0 ||
+                stats.total_cycles == 0U) {
+                continue;
+            }
+            /* per mille: busy, work, msgq, hsm, timer, other */
+            K_LOG_INFO("cpu%d %us: load %u work %u msgq %u hsm %u timer %u other %u", cpu,
+                       (unsigned int)stats.seconds, 1000U - load_pm(&stats, K_LOAD_IDLE),
+                       load_pm(&stats, K_LOAD_WORK), load_pm(&stats, K_LOAD_MSGQ),
+                       load_pm(&stats, K_LOAD_HSM), load_pm(&stats, K_LOAD_TIMER),
+                       load_pm(&stats, K_LOAD_OTHER));
+        }
+    }
+}
+
+#endif // K_CONFIG_LOAD
@@ -0,0 +1,636 @@
+/*
+ * @Date: 2026-10-20 22:41:05
+ * @FilePath: \Openy_Framework\src\k_log.c
+ * @Description: Log modules, rate limiting and deferred logging
+ *
+ * The ring is a bounded multi-producer queue of fixed slots. A producer
+ * claims a position with a CAS on the head, fills the slot and publishes
+ * it through the slot sequence, so K_LOG_* never mask interrupts and a
+ * producer preempted mid-message only holds back the consumer. Sequences
+ * are kept relative to the slot index, a zeroed ring is already empty:
+ * a slot is free for position pos when its sequence equals the lap base
+ * of pos, ready at base + 1 and freed for the next lap at base + MSGS.
+ *
+ * Arguments are packed by walking the format, which costs a scan but no
+ * formatting. The consumer walks it again and formats one conversion at a
+ * time with snprintf(), a va_list cannot be rebuilt portably. In dictionary
+ * mode the argument classes come with the call and the consumer only
+ * frames the raw words into a record.
+ */
+#include "k_kernel.h"
+
+K_LOG_MODULE_DEFINE(default, K_CONFIG_LOG_LEVEL);
+
+/* Guards every call site's rate limit window, sites may fire on any core */
+static struct k_spinlock sRateLock;
+
+/**
+ * @brief Let a rate limited call site through, behind K_LOG_*_RATELIMIT.
+ *
+ * Allows K_CONFIG_LOG_RATELIMIT_BURST messages per K_CONFIG_LOG_RATELIMIT_MS
+ * window, the window starts with the first message. What was suppressed is
+ * reported when the next window opens.
+ *
+ * @funcprops \isr_ok
+ */
+bool z_log_ratelimit(struct k_log_ratelimit *rl) {
+    uint32_t now = (uint32_t)sys_clock_tick_get();
+    uint32_t missed = 0;
+    k_spinlock_key_t key;
+    bool pass;
+
+    key = k_spin_lock(&sRateLock);
+    if (rl->count == 0U || now - rl->start >= k_ms_to_ticks_ceil32(K_CONFIG_LOG_RATELIMIT_MS)) {
+        missed = rl->missed;
+        rl->start = now;
+        rl->count = 0;
+        rl->missed = 0;
+    }
+    pass = rl->count < K_CONFIG_LOG_RATELIMIT_BURST;
+    if (pass) {
+        rl->count++;
+    } else if (rl->missed < UINT16_MAX) {
+        rl->missed++;
+    }
+    k_spin_unlock(&sRateLock, key);
+
+    if (missed != 0U) {
+        K_LOG_ERROR("%u messages suppressed by rate limit", (unsigned int)missed);
+    }
+    return pass;
+}
+
+#ifdef K_CONFIG_LOG_DEFERRED
+
+#if (K_CONFIG_LOG_MSGS & (K_CONFIG_LOG_MSGS - 1)) != 0
+#error "K_CONFIG_LOG_MSGS must be a power of 2"
+#endif
+
+#define LOG_LAP(pos)   ((uint32_t)(pos) & ~((uint32_t)K_CONFIG_LOG_MSGS - 1U))
+#define LOG_WORDS(t)   ((sizeof(t) + sizeof(uintptr_t) - 1U) / sizeof(uintptr_t))
+/* longest conversion specification copied for snprintf(), "%-+ #0*.*lld" */
+#define LOG_SPEC_MAX   16
+
+enum log_arg {
+    LOG_ARG_NONE,
+    LOG_ARG_INT,
+    LOG_ARG_LONG,
+    LOG_ARG_LLONG,
+    LOG_ARG_SIZE,
+    LOG_ARG_INTMAX,
+    LOG_ARG_PTRDIFF,
+    LOG_ARG_DOUBLE,
+    LOG_ARG_PTR,
+    LOG_ARG_BAD,
+};
+
+struct log_msg {
+    atomic_t seq;
+    const char *fmt;
+    uint8_t level;
+    /** Argument words actually packed, 32-bit ones in dictionary mode */
+    uint8_t words;
+    uintptr_t args[K_CONFIG_LOG_MSG_WORDS];
+};
+
+static struct log_msg sMsgs[K_CONFIG_LOG_MSGS];
+static atomic_t sHead;
+static uint32_t sTail;
+static atomic_t sBusy;
+static atomic_t sDropped;
+static atomic_t sTruncated;
+static uint32_t sDroppedReported;
+
+static struct k_log_backend *sBackends;
+static struct k_spinlock sBackendLock;
+
+struct k_log_backend k_log_backend_stdout = {
+    .write = k_log_backend_fwrite,
+};
+
+/* Claim the next slot, NULL when the ring is full */
+static struct log_msg *log_claim(uint32_t *pos) {
+    for (;;) {
+        uint32_t head = (uint32_t)atomic_get(&sHead);
+        struct log_msg *msg = &sMsgs[head & (K_CONFIG_LOG_MSGS - 1U)];
+        int32_t diff = (int32_t)((uint32_t)atomic_get(&msg->seq) - LOG_LAP(head));
+
+        if (diff == 0) {
+            if (atomic_cas(&sHead, (atomic_t)head, (atomic_t)(head + 1U))) {
+                *pos = head;
+                return msg;
+            }
+        } else if (diff < 0) {
+            /* still holds the previous lap, not consumed yet */
+            return NULL;
+        }
+        /* else another producer took head, retry with the new one */
+    }
+}
+
+#ifdef K_CONFIG_LOG_DICTIONARY
+
+/* argument words a slot holds, 32-bit ones here */
+#define LOG_DICT_WORDS (K_CONFIG_LOG_MSG_WORDS * sizeof(uintptr_t) / sizeof(uint32_t))
+
+BUILD_ASSERT(K_CONFIG_LOG_LINE_SIZE >=
+                 sizeof(struct k_log_dict_hdr) + LOG_DICT_WORDS * sizeof(uint32_t),
+             "K_CONFIG_LOG_LINE_SIZE too small for a dictionary record");
+
+/**
+ * @brief Queue a dictionary message, behind K_LOG_* with K_CONFIG_LOG_DICTIONARY.
+ *
+ * @a desc holds the class of every argument, so this is only the slot
+ * claim and one store per argument word, the format is never read.
+ *
+ * @funcprops \isr_ok
+ */
+void z_log_dict_put(int level, const char *fmt, uint32_t desc, ...) {
+    uint8_t *words;
+    struct log_msg *msg;
+    uint32_t pos;
+    va_list ap;
+
+    msg = log_claim(&pos);
+    if (msg == NULL) {
+        (void)atomic_inc(&sDropped);
+        return;
+    }
+
+    msg->fmt = fmt;
+    msg->level = (uint8_t)level;
+    msg->words = 0;
+    words = (uint8_t *)msg->args;
+    va_start(ap, desc);
+    for (; desc != 0U; desc >>= 2) {
+        uint32_t code = desc & 3U;
+        uint32_t n = (code == Z_LOG_ARG_WORD) ? 1U : 2U;
+        uint64_t v64;
+        uint32_t v32;
+
+        if (msg->words + n > LOG_DICT_WORDS) {
+            /* the decoder finds the arguments missing */
+            (void)atomic_inc(&sTruncated);
+            break;
+        }
+        if (code == Z_LOG_ARG_WORD) {
+            v32 = va_arg(ap, uint32_t);
+            (void)memcpy(&words[msg->words * sizeof(uint32_t)], &v32, sizeof(v32));
+        } else {
+            if (code == Z_LOG_ARG_DOUBLE) {
+                double d = va_arg(ap, double);
+                (void)memcpy(&v64, &d, sizeof(v64));
+            } else {
+                v64 = va_arg(ap, uint64_t);
+            }
+            (void)memcpy(&words[msg->words * sizeof(uint32_t)], &v64, sizeof(v64));
+        }
+        msg->words += n;
+    }
+    va_end(ap);
+
+    (void)atomic_set(&msg->seq, (atomic_t)(LOG_LAP(pos) + 1U));
+}
+
+/* Build the record of @a level, @a fmt and @a n argument words in @a buf */
+static size_t log_dict_record(char *buf, uint8_t level, const char *fmt, const void *words,
+                              uint8_t n) {
+    struct k_log_dict_hdr hdr;
+
+    hdr.magic = K_LOG_DICT_MAGIC;
+    hdr.level = level;
+    hdr.words = n;
+    hdr.reserved = 0;
+    hdr.fmt = (uint32_t)(uintptr_t)fmt;
+    (void)memcpy(buf, &hdr, sizeof(hdr));
+    (void)memcpy(&buf[sizeof(hdr)], words, n * sizeof(uint32_t));
+    return sizeof(hdr) + n * sizeof(uint32_t);
+}
+
+#else
+
+/*
+ * Parse the conversion specification after a '%'. Returns its last
+ * character, the terminator when the format ends inside it.
+ */
+static const char *log_spec(const char *p, uint8_t *type, uint8_t *stars) {
+    char len = 0;
+
+    *stars = 0;
+    while (*p == '-' || *p == '+' || *p == ' ' || *p == '#' || *p == '0') {
+        p++;
+    }
+    if (*p == '*') {
+        (*stars)++;
+        p++;
+    }
+    while (*p >= '0' && *p <= '9') {
+        p++;
+    }
+    if (*p == '.') {
+        p++;
+        if (*p == '*') {
+            (*stars)++;
+            p++;
+        }
+        while (*p >= '0' && *p <= '9') {
+            p++;
+        }
+    }
+
+    switch (*p) {
+    case 'h':
+        p += (p[1] == 'h') ? 2 : 1;
+        break;
+    case 'l':
+        len = (p[1] == 'l') ? 'q' : 'l';
+        p += (p[1] == 'l') ? 2 : 1;
+        break;
+    case 'z':
+    case 'j':
+    case 't':
+    case 'L':
+        len = *p++;
+        break;
+    default:
+        break;
+    }
+
+    switch (*p) {
+    case 'd':
+    case 'i':
+    case 'u':
+    case 'x':
+    case 'X':
+    case 'o':
+    case 'c':
+        *type = len == 0     ? LOG_ARG_INT
+                : len == 'l' ? LOG_ARG_LONG
+                : len == 'q' ? LOG_ARG_LLONG
+                : len == 'z' ? LOG_ARG_SIZE
+                : len == 'j' ? LOG_ARG_INTMAX
+                : len == 't' ? LOG_ARG_PTRDIFF
+                             : LOG_ARG_BAD;
+        break;
+    case 'f':
+    case 'F':
+    case 'e':
+    case 'E':
+    case 'g':
+    case 'G':
+    case 'a':
+    case 'A':
+        *type = len == 'L' ? LOG_ARG_BAD : LOG_ARG_DOUBLE;
+        break;
+    case 's':
+    case 'p':
+        *type = LOG_ARG_PTR;
+        break;
+    case '%':
+        *type = LOG_ARG_NONE;
+        break;
+    default:
+        /* %n, long double and unknown conversions are not carried */
+        *type = LOG_ARG_BAD;
+        break;
+    }
+    return p;
+}
+
+#define LOG_PACK(t)                                                                                \
+    do {                                                                                           \
+        t v_ = va_arg(ap, t);                                                                      \
+        if (msg->words + LOG_WORDS(t) > K_CONFIG_LOG_MSG_WORDS) {                                  \
+            return;                                                                                \
+        }                                                                                          \
+        (void)memcpy(&msg->args[msg->words], &v_, sizeof(v_));                                     \
+        msg->words += LOG_WORDS(t);                                                                \
+    } while (0)
+
+/*
+ * Copy the arguments @a fmt consumes. Stops at the first one that does not
+ * fit, the consumer finds it missing and counts the message as truncated.
+ */
+static void log_pack(struct log_msg *msg, const char *fmt, va_list ap) {
+    uint8_t type;
+    uint8_t stars;
+
+    msg->words = 0;
+    for (const char *p = fmt; *p != '\0'; p++) {
+        if (*p != '%') {
+            continue;
+        }
+        p = log_spec(p + 1, &type, &stars);
+        if (type == LOG_ARG_BAD) {
+            return;
+        }
+        for (uint8_t i = 0; i < stars; i++) {
+            LOG_PACK(int);
+        }
+
+        switch (type) {
+        case LOG_ARG_INT:
+            LOG_PACK(int);
+            break;
+        case LOG_ARG_LONG:
+            LOG_PACK(long);
+            break;
+        case LOG_ARG_LLONG:
+            LOG_PACK(long long);
+            break;
+        case LOG_ARG_SIZE:
+            LOG_PACK(size_t);
+            break;
+        case LOG_ARG_INTMAX:
+            LOG_PACK(intmax_t);
+            break;
+        case LOG_ARG_PTRDIFF:
+            LOG_PACK(ptrdiff_t);
+            break;
+        case LOG_ARG_DOUBLE:
+            LOG_PACK(double);
+            break;
+        case LOG_ARG_PTR:
+            LOG_PACK(void *);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Queue a message, behind K_LOG_INFO/DEBUG/ERROR.
+ *
+ * @funcprops \isr_ok
+ */
+void z_log_put(int level, const char *fmt, ...) {
+    struct log_msg *msg;
+    uint32_t pos;
+    va_list ap;
+
+    msg = log_claim(&pos);
+    if (msg == NULL) {
+        (void)atomic_inc(&sDropped);
+        return;
+    }
+
+    msg->fmt = fmt;
+    msg->level = (uint8_t)level;
+    va_start(ap, fmt);
+    log_pack(msg, fmt, ap);
+    va_end(ap);
+
+    (void)atomic_set(&msg->seq, (atomic_t)(LOG_LAP(pos) + 1U));
+}
+
+#define LOG_SNPRINTF(t)                                                                            \
+    do {                                                                                           \
+        t v_;                                                                                      \
+        (void)memcpy(&v_, arg, sizeof(v_));                                                        \
+        n = stars == 0   ? snprintf(buf, size, spec, v_)                                           \
+            : stars == 1 ? snprintf(buf, size, spec, sw[0], v_)                                    \
+                         : snprintf(buf, size, spec, sw[0], sw[1], v_);                            \
+    } while (0)
+
+static size_t log_arg_words(uint8_t type) {
+    switch (type) {
+    case LOG_ARG_INT:
+        return LOG_WORDS(int);
+    case LOG_ARG_LONG:
+        return LOG_WORDS(long);
+    case LOG_ARG_LLONG:
+        return LOG_WORDS(long long);
+    case LOG_ARG_SIZE:
+        return LOG_WORDS(size_t);
+    case LOG_ARG_INTMAX:
+        return LOG_WORDS(intmax_t);
+    case LOG_ARG_PTRDIFF:
+        return LOG_WORDS(ptrdiff_t);
+    case LOG_ARG_DOUBLE:
+        return LOG_WORDS(double);
+    case LOG_ARG_PTR:
+        return LOG_WORDS(void *);
+    default:
+        return 0;
+    }
+}
+
+/* Format one conversion, returns the words consumed or 0 when they are missing */
+static size_t log_conv(char *buf, size_t size, const char *spec, uint8_t type, uint8_t stars,
+                       const struct log_msg *msg, size_t w, int *out) {
+    size_t used = stars * LOG_WORDS(int) + log_arg_words(type);
+    const uintptr_t *arg;
+    int sw[2];
+    int n = 0;
+
+    if (w + used > msg->words) {
+        return 0;
+    }
+    for (uint8_t i = 0; i < stars; i++) {
+        (void)memcpy(&sw[i], &msg->args[w], sizeof(int));
+        w += LOG_WORDS(int);
+    }
+    arg = &msg->args[w];
+
+    switch (type) {
+    case LOG_ARG_INT:
+        LOG_SNPRINTF(int);
+        break;
+    case LOG_ARG_LONG:
+        LOG_SNPRINTF(long);
+        break;
+    case LOG_ARG_LLONG:
+        LOG_SNPRINTF(long long);
+        break;
+    case LOG_ARG_SIZE:
+        LOG_SNPRINTF(size_t);
+        break;
+    case LOG_ARG_INTMAX:
+        LOG_SNPRINTF(intmax_t);
+        break;
+    case LOG_ARG_PTRDIFF:
+        LOG_SNPRINTF(ptrdiff_t);
+        break;
+    case LOG_ARG_DOUBLE:
+        LOG_SNPRINTF(double);
+        break;
+    case LOG_ARG_PTR:
+        LOG_SNPRINTF(void *);
+        break;
+    default:
+        return 0;
+    }
+
+    *out = n;
+    return used;
+}
+
+/*
+ * Format @a msg into @a buf as one line with its newline. Stops at the
+ * first conversion whose arguments were not packed.
+ */
+static size_t log_format(const struct log_msg *msg, char *buf, size_t size, bool *cut) {
+    static const char *const level_str[] = {"[INFO] ", "[DEBUG] ", "[ERROR] "};
+    /* the last byte is kept for the newline */
+    size_t room = size - 1U;
+    const char *p = msg->fmt;
+    size_t len;
+    size_t w = 0;
+
+    len = (size_t)snprintf(buf, room, "%s", level_str[msg->level]);
+    while (*p != '\0' && len < room - 1U) {
+        char spec[LOG_SPEC_MAX];
+        const char *end;
+        uint8_t type;
+        uint8_t stars;
+        size_t used;
+        int n;
+
+        if (*p != '%') {
+            buf[len++] = *p++;
+            continue;
+        }
+        end = log_spec(p + 1, &type, &stars);
+        if (type == LOG_ARG_NONE) {
+            buf[len++] = '%';
+            p = end + 1;
+            continue;
+        }
+        if (type == LOG_ARG_BAD || (size_t)(end - p) + 2U > sizeof(spec)) {
+            *cut = true;
+            break;
+        }
+        (void)memcpy(spec, p, (size_t)(end - p) + 1U);
+        spec[end - p + 1] = '\0';
+
+        used = log_conv(&buf[len], room - len, spec, type, stars, msg, w, &n);
+        if (used == 0U || n < 0) {
+            *cut = true;
+            break;
+        }
+        w += used;
+        if ((size_t)n > room - len - 1U) {
+            *cut = true;
+            n = (int)(room - len - 1U);
+        }
+        len += (size_t)n;
+        p = end + 1;
+    }
+    if (*p != '\0') {
+        *cut = true;
+    }
+
+    buf[len++] = '\n';
+    return len;
+}
+
+#endif // K_CONFIG_LOG_DICTIONARY
+
+static void log_output(const char *line, size_t len) {
+    struct k_log_backend *backend = sBackends;
+
+    if (backend == NULL) {
+        k_log_backend_stdout.write(&k_log_backend_stdout, line, len);
+        return;
+    }
+    for (; backend != NULL; backend = backend->next) {
+        backend->write(backend, line, len);
+    }
+}
+
+/**
+ * @brief Output every message as well through @a backend.
+ *
+ * Until one is added the lines go to k_log_backend_stdout.
+ */
+void k_log_backend_add(struct k_log_backend *backend) {
+    k_spinlock_key_t key = k_spin_lock(&sBackendLock);
+
+    backend->next = sBackends;
+    sBackends = backend;
+    k_spin_unlock(&sBackendLock, key);
+}
+
+void k_log_backend_fwrite(const struct k_log_backend *backend, const char *data, size_t len) {
+    FILE *fp = (backend->user_data != NULL) ? (FILE *)backend->user_data : K_LOG_OUTPUT_STREAM;
+
+    (void)fwrite(data, 1, len, fp);
+}
+
+/**
+ * @brief Format and output the oldest message.
+ *
+ * Called by k_run() when nothing is ready, or from a work item or the main
+ * loop. Only one context processes at a time, others return false.
+ *
+ * @retval true a line was output, there may be more
+ * @retval false the ring is empty or another context is processing
+ */
+bool k_log_process(void) {
+    static char line[K_CONFIG_LOG_LINE_SIZE];
+    struct log_msg *msg;
+    uint32_t dropped;
+    size_t len;
+#ifndef K_CONFIG_LOG_DICTIONARY
+    bool cut = false;
+#endif
+
+    if (!atomic_cas(&sBusy, 0, 1)) {
+        return false;
+    }
+
+    dropped = (uint32_t)atomic_get(&sDropped);
+    if (dropped != sDroppedReported) {
+#ifdef K_CONFIG_LOG_DICTIONARY
+        uint32_t count = dropped - sDroppedReported;
+
+        len = log_dict_record(line, K_LOG_DICT_DROPPED, NULL, &count, 1);
+#else
+        len = (size_t)snprintf(line, sizeof(line), "[ERROR] %u log messages dropped\n",
+                               (unsigned int)(dropped - sDroppedReported));
+        len = MIN(len, sizeof(line) - 1U);
+#endif
+        sDroppedReported = dropped;
+        log_output(line, len);
+        (void)atomic_set(&sBusy, 0);
+        return true;
+    }
+
+    msg = &sMsgs[sTail & (K_CONFIG_LOG_MSGS - 1U)];
+    if ((uint32_t)atomic_get(&msg->seq) != LOG_LAP(sTail) + 1U) {
+        (void)atomic_set(&sBusy, 0);
+        return false;
+    }
+
+#ifdef K_CONFIG_LOG_DICTIONARY
+    len = log_dict_record(line, msg->level, msg->fmt, msg->args, msg->words);
+#else
+    len = log_format(msg, line, sizeof(line), &cut);
+    if (cut) {
+        (void)atomic_inc(&sTruncated);
+    }
+#endif
+    /* the line is built, give the slot back before the slow part */
+    (void)atomic_set(&msg->seq, (atomic_t)(LOG_LAP(sTail) + K_CONFIG_LOG_MSGS));
+    sTail++;
+
+    log_output(line, len);
+    (void)atomic_set(&sBusy, 0);
+    return true;
+}
+
+/**
+ * @brief Output everything queued, e.g. before a reset or a fatal halt.
+ */
+void k_log_flush(void) {
+    while (k_log_process()) {
+    }
+}
+
+void k_log_overflow_get(struct k_log_overflow *overflow) {
+    overflow->dropped = (uint32_t)atomic_get(&sDropped);
+    overflow->truncated = (uint32_t)atomic_get(&sTruncated);
+}
+
+#endif // K_CONFIG_LOG_DEFERRED
@@ -0,0 +1,261 @@
+/*
+ * @Date: 2026-10-20 13:40:18
+ * @FilePath: \Openy_Framework\src\k_malloc_track.c
+ * @Description: Accounting and leak tracking behind K_MALLOC/K_FREE
+ *
+ * Every block gets a small header linking it into the list of outstanding
+ * allocations and pointing at its call site entry, so a free knows what
+ * to credit without any search and the list is exactly the set of leaks
+ * when the system is expected to be idle.
+ */
+#include "k_kernel.h"
+
+#ifdef K_CONFIG_MALLOC_TRACK
+
+/* the header must not promise more alignment than the raw allocator gives,
+ * and its size keeps the payload on that same alignment
+ */
+#if defined(K_CONFIG_HEAP) && defined(K_CONFIG_HEAP_MALLOC)
+#define TRACK_HDR_ALIGN K_HEAP_ALIGN_SIZE
+#else
+#define TRACK_HDR_ALIGN 8
+#endif
+
+struct track_hdr {
+    sys_dnode_t node;
+    struct k_malloc_track_site *site;
+    size_t size;
+} __attribute__((__aligned__(TRACK_HDR_ALIGN)));
+
+/* outstanding blocks copied per lock hold by k_malloc_track_dump() */
+#define TRACK_DUMP_CHUNK 8
+
+struct track_entry {
+    const void *ptr;
+    size_t size;
+    const char *file;
+    int line;
+};
+
+static sys_dlist_t sOutstanding = SYS_DLIST_STATIC_INIT(&sOutstanding);
+static struct k_malloc_track_site sSites[K_CONFIG_MALLOC_TRACK_SITES];
+static struct k_malloc_track_stats sStats;
+static struct k_spinlock sLock;
+
+static inline int track_bucket(size_t size) {
+    int bucket = 0;
+
+    while (size != 0U && bucket < K_MALLOC_TRACK_HIST_BUCKETS - 1) {
+        size >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+/* Entry of a call site, called with sLock held */
+static struct k_malloc_track_site *track_site(const char *file, int line) {
+    struct k_malloc_track_site *site;
+
+    for (site = sSites; site < &sSites[K_CONFIG_MALLOC_TRACK_SITES - 1]; site++) {
+        if (site->file == NULL) {
+            site->file = file;
+            site->line = line;
+            return site;
+        }
+        if (site->line == line && (site->file == file || strcmp(site->file, file) == 0)) {
+            return site;
+        }
+    }
+
+    site->file = "other";
+    site->line = 0;
+    return site;
+}
+
+/**
+ * @brief K_MALLOC with accounting, use through K_MALLOC.
+ */
+void *k_malloc_track(size_t size, const char *file, int line) {
+    struct track_hdr *hdr = Z_MALLOC_RAW(sizeof(struct track_hdr) + size);
+    struct k_malloc_track_site *site;
+    k_spinlock_key_t key = k_spin_lock(&sLock);
+
+    if (hdr == NULL) {
+        sStats.fail_count++;
+        k_spin_unlock(&sLock, key);
+        return NULL;
+    }
+
+    site = track_site(file, line);
+    site->cur_bytes += size;
+    site->cur_count++;
+    site->total_count++;
+    if (site->cur_bytes > site->peak_bytes) {
+        site->peak_bytes = site->cur_bytes;
+    }
+
+    sStats.cur_bytes += size;
+    sStats.cur_count++;
+    sStats.total_count++;
+    if (sStats.cur_bytes > sStats.peak_bytes) {
+        sStats.peak_bytes = sStats.cur_bytes;
+    }
+    sStats.hist[track_bucket(size)]++;
+
+    hdr->site = site;
+    hdr->size = size;
+    sys_dlist_append(&sOutstanding, &hdr->node);
+
+    k_spin_unlock(&sLock, key);
+
+    return hdr + 1;
+}
+
+/**
+ * @brief K_FREE with accounting, use through K_FREE.
+ */
+void k_free_track(void *ptr) {
+    struct track_hdr *hdr;
+    k_spinlock_key_t key;
+
+    if (ptr == NULL) {
+        return;
+    }
+    hdr = (struct track_hdr *)ptr - 1;
+    __ASSERT(sys_dnode_is_linked(&hdr->node), "free of untracked block %p", ptr);
+
+    key = k_spin_lock(&sLock);
+    sys_dlist_remove(&hdr->node);
+    hdr->site->cur_bytes -= hdr->size;
+    hdr->site->cur_count--;
+    sStats.cur_bytes -= hdr->size;
+    sStats.cur_count--;
+    k_spin_unlock(&sLock, key);
+
+    Z_FREE_RAW(hdr);
+}
+
+void k_malloc_track_stats_get(struct k_malloc_track_stats *stats) {
+    k_spinlock_key_t key = k_spin_lock(&sLock);
+    *stats = sStats;
+    k_spin_unlock(&sLock, key);
+}
+
+/**
+ * @brief Copy the call site entry @a index.
+ *
+ * @retval 0 on success
+ * @retval -EINVAL @a index is out of range or not used yet
+ */
+int k_malloc_track_site_get(int index, struct k_malloc_track_site *site) {
+    int err = -EINVAL;
+
+    if (index >= 0 && index < K_CONFIG_MALLOC_TRACK_SITES) {
+        k_spinlock_key_t key = k_spin_lock(&sLock);
+        if (sSites[index].file != NULL) {
+            *site = sSites[index];
+            err = 0;
+        }
+        k_spin_unlock(&sLock, key);
+    }
+    return err;
+}
+
+/**
+ * @brief Call @a cb for every outstanding allocation, oldest first.
+ *
+ * Runs with the tracker locked for the whole walk, @a cb must not allocate
+ * or free. Meant for leak hunting from a quiet context.
+ */
+void k_malloc_track_foreach(k_malloc_track_cb_t cb, void *user_data) {
+    sys_dnode_t *node;
+    k_spinlock_key_t key = k_spin_lock(&sLock);
+
+    SYS_DLIST_FOR_EACH_NODE(&sOutstanding, node) {
+        struct track_hdr *hdr = CONTAINER_OF(node, struct track_hdr, node);
+
+        cb(hdr + 1, hdr->size, hdr->site->file, hdr->site->line, user_data);
+    }
+
+    k_spin_unlock(&sLock, key);
+}
+
+/* Copy up to @a max outstanding blocks, after skipping the first @a skip */
+static int track_snapshot(struct track_entry *out, int skip, int max) {
+    sys_dnode_t *node;
+    int n = 0;
+    k_spinlock_key_t key = k_spin_lock(&sLock);
+
+    SYS_DLIST_FOR_EACH_NODE(&sOutstanding, node) {
+        struct track_hdr *hdr;
+
+        if (skip > 0) {
+            skip--;
+            continue;
+        }
+        if (n == max) {
+            break;
+        }
+        hdr = CONTAINER_OF(node, struct track_hdr, node);
+        out[n].ptr = hdr + 1;
+        out[n].size = hdr->size;
+        out[n].file = hdr->site->file;
+        out[n].line = hdr->site->line;
+        n++;
+    }
+
+    k_spin_unlock(&sLock, key);
+    return n;
+}
+
+/**
+ * @brief Print totals, histogram, call sites and outstanding allocations.
+ *
+ * Everything is copied under the lock and logged after releasing it, so
+ * a slow log backend never extends the masked region.
+ */
+void k_malloc_track_dump(void) {
+    struct k_malloc_track_stats stats;
+    struct k_malloc_track_site site;
+
+    k_malloc_track_stats_get(&stats);
+    K_LOG_INFO("heap: %u bytes in %u blocks, peak %u, %u allocs, %u failed",
+               (unsigned int)stats.cur_bytes, (unsigned int)stats.cur_count,
+               (unsigned int)stats.peak_bytes, (unsigned int)stats.total_count,
+               (unsigned int)stats.fail_count);
+
+    for (int i = 0; i < K_MALLOC_TRACK_HIST_BUCKETS; i++) {
+        if (stats.hist[i] != 0U) {
+            if (i == K_MALLOC_TRACK_HIST_BUCKETS - 1) {
+                K_LOG_INFO("  >= %u: %u", 1U << (i - 1), (unsigned int)stats.hist[i]);
+            } else {
+                K_LOG_INFO("  < %u: %u", 1U << i, (unsigned int)stats.hist[i]);
+            }
+        }
+    }
+
+    for (int i = 0; k_malloc_track_site_get(i, &site) == 0; i++) {
+        K_LOG_INFO("  %s:%d %u bytes in %u blocks, peak %u, %u allocs", site.file, site.line,
+                   (unsigned int)site.cur_bytes, (unsigned int)site.cur_count,
+                   (unsigned int)site.peak_bytes, (unsigned int)site.total_count);
+    }
+
+    /* a few blocks per lock hold, printed with the lock released; blocks
+     * allocated or freed meanwhile may be missed or shown twice
+     */
+    for (int done = 0;;) {
+        struct track_entry chunk[TRACK_DUMP_CHUNK];
+        int n = track_snapshot(chunk, done, TRACK_DUMP_CHUNK);
+
+        for (int i = 0; i < n; i++) {
+            K_LOG_INFO("  %p %u bytes %s:%d", chunk[i].ptr, (unsigned int)chunk[i].size,
+                       chunk[i].file, chunk[i].line);
+        }
+        if (n < TRACK_DUMP_CHUNK) {
+            break;
+        }
+        done += n;
+    }
+}
+
+#endif // K_CONFIG_MALLOC_TRACK
@@ -0,0 +1,134 @@
+/*
+ * @Date: 2026-10-20 10:02:37
+ * @FilePath: \Openy_Framework\src\k_mem_slab.c
+ * @Description: Fixed-size block allocator
+ *
+ * Freed blocks are kept on a k_lifo, blocks that were never allocated are
+ * claimed from the fresh watermark with atomic_cas(). Both alloc and free
+ * are a few atomic operations whatever the number of blocks, never mask
+ * interrupts and are safe across cores, and a statically defined slab
+ * needs no initialization pass.
+ */
+#include "k_kernel.h"
+
+#ifdef K_CONFIG_MEM_SLAB
+
+/**
+ * @brief Initialize a memory slab.
+ *
+ * @param slab Address of the memory slab.
+ * @param buffer Block storage, at least @a block_size * @a num_blocks bytes,
+ *        aligned on a pointer boundary.
+ * @param block_size Size of each block (in bytes).
+ * @param num_blocks Number of blocks.
+ *
+ * @retval 0 on success
+ * @retval -EINVAL @a block_size or @a buffer is not pointer aligned, or the
+ *         buffer is too large for a k_lifo region (see k_lifo_init())
+ */
+int k_mem_slab_init(k_mem_slab_t *slab, void *buffer, size_t block_size, uint32_t num_blocks) {
+    if (block_size < sizeof(void *) || (block_size % sizeof(void *)) != 0U ||
+        k_lifo_init(&slab->free_list, buffer, block_size * num_blocks) != 0) {
+        return -EINVAL;
+    }
+
+    slab->buffer = (char *)buffer;
+    slab->block_size = block_size;
+    slab->num_blocks = num_blocks;
+    (void)atomic_set(&slab->fresh, 0);
+    (void)atomic_set(&slab->num_used, 0);
+    (void)atomic_set(&slab->max_used, 0);
+
+    return 0;
+}
+
+/* Claim a never used block, NULL once the watermark reached the end */
+static char *slab_take_fresh(k_mem_slab_t *slab) {
+    atomic_t fresh;
+
+    do {
+        fresh = atomic_get(&slab->fresh);
+        if ((uint32_t)fresh >= slab->num_blocks) {
+            return NULL;
+        }
+    } while (!atomic_cas(&slab->fresh, fresh, fresh + 1));
+
+    return slab->buffer + (size_t)fresh * slab->block_size;
+}
+
+/**
+ * @brief Allocate a block.
+ *
+ * @funcprops \isr_ok
+ *
+ * @param slab Address of the memory slab.
+ * @param mem Area to store the block address, set to NULL on failure.
+ *
+ * @retval 0 on success
+ * @retval -ENOMEM all blocks are in use
+ */
+int k_mem_slab_alloc(k_mem_slab_t *slab, void **mem) {
+    char *block = k_lifo_pop(&slab->free_list);
+    atomic_t used, max;
+
+    if (block == NULL) {
+        block = slab_take_fresh(slab);
+        if (block == NULL) {
+            /* the watermark never moves back, only a concurrent free helps */
+            block = k_lifo_pop(&slab->free_list);
+        }
+    }
+
+    *mem = block;
+    if (block == NULL) {
+        return -ENOMEM;
+    }
+
+    used = atomic_inc(&slab->num_used) + 1;
+    do {
+        max = atomic_get(&slab->max_used);
+    } while (used > max && !atomic_cas(&slab->max_used, max, used));
+
+    return 0;
+}
+
+/**
+ * @brief Free a block obtained from k_mem_slab_alloc().
+ *
+ * @funcprops \isr_ok
+ *
+ * @param slab Address of the memory slab.
+ * @param mem Block to free.
+ */
+void k_mem_slab_free(k_mem_slab_t *slab, void *mem) {
+    __ASSERT((char *)mem >= slab->buffer &&
+                 (char *)mem < slab->buffer + slab->num_blocks * slab->block_size &&
+                 ((size_t)((char *)mem - slab->buffer) % slab->block_size) == 0U,
+             "block %p does not belong to slab %p", mem, slab);
+
+    /* count first so num_used never exceeds num_blocks */
+    (void)atomic_dec(&slab->num_used);
+    k_lifo_push(&slab->free_list, mem);
+}
+
+uint32_t k_mem_slab_num_used_get(k_mem_slab_t *slab) {
+    return (uint32_t)atomic_get(&slab->num_used);
+}
+
+uint32_t k_mem_slab_num_free_get(k_mem_slab_t *slab) {
+    return slab->num_blocks - (uint32_t)atomic_get(&slab->num_used);
+}
+
+/**
+ * @brief Largest number of blocks simultaneously in use since init or the
+ * last k_mem_slab_runtime_stats_reset_max().
+ */
+uint32_t k_mem_slab_max_used_get(k_mem_slab_t *slab) {
+    return (uint32_t)atomic_get(&slab->max_used);
+}
+
+void k_mem_slab_runtime_stats_reset_max(k_mem_slab_t *slab) {
+    (void)atomic_set(&slab->max_used, atomic_get(&slab->num_used));
+}
+
+#endif // K_CONFIG_MEM_SLAB
@@ -16,14 +16,35 @@ void k_msgq_init(k_msgq_t *msgq, char *buffer, size_t msg_size, uint32_t max_msg
     msgq->read_ptr = buffer;
     msgq->write_ptr = buffer;
     msgq->used_msgs = 0;
-    msgq->lock = 0;
+    msgq->lock = (struct k_spinlock){0};
+    msgq->notify = NULL;
+    msgq->notify_data = NULL;
+    msgq->flags = 0;
+    msgq->dropped_msgs = 0;
+    K_OBJ_STATS_INIT(&msgq->stats, K_OBJ_STATS_MSGQ, max_msgs);
+}
+
+/* Discard the @a n oldest messages, called with the lock held */
+static inline void msgq_drop_oldest(k_msgq_t *msgq, uint32_t n) {
+    msgq->read_ptr += n * msgq->msg_size;
+    if (msgq->read_ptr >= msgq->buffer_end) {
+        msgq->read_ptr -= msgq->buffer_end - msgq->buffer_start;
+    }
+    msgq->used_msgs -= n;
+    msgq->dropped_msgs += n;
 }
 
 int k_msgq_put(k_msgq_t *msgq, const void *data) {
+    k_msgq_notify_t notify;
+    void *notify_data;
     int result;
 
     /* lock */
-    msgq->lock = k_interrupt_disable();
+    k_spinlock_key_t key = k_spin_lock(&msgq->lock);
+
+    if (msgq->used_msgs == msgq->max_msgs && (msgq->flags & K_MSGQ_FLAG_OVERWRITE) != 0U) {
+        msgq_drop_oldest(msgq, 1);
+    }
 
     if (msgq->used_msgs < msgq->max_msgs) {
         /* message queue isn't full */
@@ -36,13 +57,24 @@ int k_msgq_put(k_msgq_t *msgq, const void *data) {
             msgq->write_ptr = msgq->buffer_start;
         }
         msgq->used_msgs++;
+        K_TRACE_MSGQ_PUT(msgq, msgq->used_msgs);
         result = 0;
     } else {
+        K_TRACE_MSGQ_FULL(msgq);
         result = -ENOMEM;
     }
+    K_OBJ_STATS_PUT(&msgq->stats, K_OBJ_STATS_MSGQ, result == 0 ? 1 : 0, result == 0 ? 0 : 1,
+                    msgq->used_msgs, msgq->max_msgs);
+    /* the pair is set together under the lock, take it the same way */
+    notify = msgq->notify;
+    notify_data = msgq->notify_data;
 
     /* unlock */
-    k_interrupt_enable(msgq->lock);
+    k_spin_unlock(&msgq->lock, key);
+
+    if (result == 0 && notify != NULL) {
+        notify(msgq, notify_data);
+    }
 
     return result;
 }
@@ -51,7 +83,7 @@ int k_msgq_get(k_msgq_t *msgq, void *data) {
     int result;
 
     /* lock */
-    msgq->lock = k_interrupt_disable();
+    k_spinlock_key_t key = k_spin_lock(&msgq->lock);
     if (msgq->used_msgs > 0U) {
         /* take first available message from queue */
         (void)K_MEMCPY(data, msgq->read_ptr, msgq->msg_size);
@@ -60,30 +92,149 @@ int k_msgq_get(k_msgq_t *msgq, void *data) {
             msgq->read_ptr = msgq->buffer_start;
         }
         msgq->used_msgs--;
+        K_OBJ_STATS_GET(&msgq->stats, 1, msgq->used_msgs);
+        K_TRACE_MSGQ_GET(msgq, msgq->used_msgs);
 
         result = 0;
     } else {
         result = -EINVAL;
     }
     /* unlock */
-    k_interrupt_enable(msgq->lock);
+    k_spin_unlock(&msgq->lock, key);
 
     return result;
 }
 
+/**
+ * @brief Put up to @a n messages in a single critical section.
+ *
+ * The messages are copied with at most two memcpy runs, one up to the end
+ * of the buffer and one from its start.
+ *
+ * @param msgq Address of the message queue.
+ * @param data Array of @a n messages.
+ * @param n Number of messages to put.
+ *
+ * In overwrite mode all @a n messages are accepted: the oldest queued ones,
+ * and the head of @a data itself if @a n exceeds the queue depth, are
+ * dropped so that the newest max_msgs messages are kept.
+ *
+ * @return Number of messages accepted, less than @a n if the queue filled up.
+ */
+uint32_t k_msgq_put_n(k_msgq_t *msgq, const void *data, uint32_t n) {
+    const char *src = (const char *)data;
+    k_msgq_notify_t notify;
+    void *notify_data;
+    uint32_t accepted = n;
+    uint32_t rejected = 0;
+    size_t run;
+
+    /* lock */
+    k_spinlock_key_t key = k_spin_lock(&msgq->lock);
+
+    if ((msgq->flags & K_MSGQ_FLAG_OVERWRITE) != 0U) {
+        if (n > msgq->max_msgs) {
+            src += (n - msgq->max_msgs) * msgq->msg_size;
+            msgq->dropped_msgs += n - msgq->max_msgs;
+            n = msgq->max_msgs;
+        }
+        if (n > msgq->max_msgs - msgq->used_msgs) {
+            msgq_drop_oldest(msgq, n - (msgq->max_msgs - msgq->used_msgs));
+        }
+    } else {
+        n = MIN(n, msgq->max_msgs - msgq->used_msgs);
+        rejected = accepted - n;
+        accepted = n;
+    }
+
+    if (n > 0U) {
+        size_t bytes = n * msgq->msg_size;
+
+        run = MIN(bytes, (size_t)(msgq->buffer_end - msgq->write_ptr));
+        (void)K_MEMCPY(msgq->write_ptr, src, run);
+        msgq->write_ptr += run;
+        if (msgq->write_ptr == msgq->buffer_end) {
+            msgq->write_ptr = msgq->buffer_start;
+        }
+        if (bytes > run) {
+            (void)K_MEMCPY(msgq->write_ptr, src + run, bytes - run);
+            msgq->write_ptr += bytes - run;
+        }
+        msgq->used_msgs += n;
+        K_TRACE_MSGQ_PUT(msgq, msgq->used_msgs);
+    }
+    if (rejected != 0U) {
+        K_TRACE_MSGQ_FULL(msgq);
+    }
+    K_OBJ_STATS_PUT(&msgq->stats, K_OBJ_STATS_MSGQ, n, rejected, msgq->used_msgs, msgq->max_msgs);
+    notify = msgq->notify;
+    notify_data = msgq->notify_data;
+
+    /* unlock */
+    k_spin_unlock(&msgq->lock, key);
+
+    if (n > 0U && notify != NULL) {
+        notify(msgq, notify_data);
+    }
+
+    return accepted;
+}
+
+/**
+ * @brief Get up to @a n messages in a single critical section.
+ *
+ * @param msgq Address of the message queue.
+ * @param data Area for @a n messages.
+ * @param n Number of messages to get.
+ *
+ * @return Number of messages actually copied to @a data.
+ */
+uint32_t k_msgq_get_n(k_msgq_t *msgq, void *data, uint32_t n) {
+    char *dst = (char *)data;
+    size_t run;
+
+    /* lock */
+    k_spinlock_key_t key = k_spin_lock(&msgq->lock);
+
+    n = MIN(n, msgq->used_msgs);
+    if (n > 0U) {
+        size_t bytes = n * msgq->msg_size;
+
+        run = MIN(bytes, (size_t)(msgq->buffer_end - msgq->read_ptr));
+        (void)K_MEMCPY(dst, msgq->read_ptr, run);
+        msgq->read_ptr += run;
+        if (msgq->read_ptr == msgq->buffer_end) {
+            msgq->read_ptr = msgq->buffer_start;
+        }
+        if (bytes > run) {
+            (void)K_MEMCPY(dst + run, msgq->read_ptr, bytes - run);
+            msgq->read_ptr += bytes - run;
+        }
+        msgq->used_msgs -= n;
+        K_OBJ_STATS_GET(&msgq->stats, n, msgq->used_msgs);
+        K_TRACE_MSGQ_GET(msgq, msgq->used_msgs);
+    }
+
+    /* unlock */
+    k_spin_unlock(&msgq->lock, key);
+
+    return n;
+}
+
 void k_msgq_purge(k_msgq_t *msgq) {
     /* lock */
-    msgq->lock = k_interrupt_disable();
+    k_spinlock_key_t key = k_spin_lock(&msgq->lock);
     msgq->used_msgs = 0;
     msgq->read_ptr = msgq->write_ptr;
+    K_OBJ_STATS_GET(&msgq->stats, 0, 0);
     /* unlock */
-    k_interrupt_enable(msgq->lock);
+    k_spin_unlock(&msgq->lock, key);
 }
 
 int k_msgq_peek(struct k_msgq *msgq, void *data) {
     int result;
     /* lock */
-    msgq->lock = k_interrupt_disable();
+    k_spinlock_key_t key = k_spin_lock(&msgq->lock);
     if (msgq->used_msgs > 0U) {
         /* take first available message from queue */
         (void)K_MEMCPY(data, msgq->read_ptr, msgq->msg_size);
@@ -93,8 +244,53 @@ int k_msgq_peek(struct k_msgq *msgq, void *data) {
         result = -EINVAL;
     }
     /* unlock */
-    k_interrupt_enable(msgq->lock);
+    k_spin_unlock(&msgq->lock, key);
     return result;
 }
 
+/**
+ * @brief Enable or disable overwrite-oldest mode.
+ *
+ * In overwrite mode a put on a full queue never fails: the oldest message
+ * is discarded in the same critical section as the write and counted in
+ * the dropped counter, so a slow consumer always sees the newest messages.
+ *
+ * @param msgq Address of the message queue.
+ * @param enable true to overwrite, false to fail with -ENOMEM when full.
+ */
+void k_msgq_set_overwrite(k_msgq_t *msgq, bool enable) {
+    k_spinlock_key_t key = k_spin_lock(&msgq->lock);
+    if (enable) {
+        msgq->flags |= K_MSGQ_FLAG_OVERWRITE;
+    } else {
+        msgq->flags &= ~K_MSGQ_FLAG_OVERWRITE;
+    }
+    k_spin_unlock(&msgq->lock, key);
+}
+
+/**
+ * @brief Number of messages discarded in overwrite mode since init.
+ *
+ * @param msgq Address of the message queue.
+ */
+uint32_t k_msgq_dropped_get(k_msgq_t *msgq) { return msgq->dropped_msgs; }
+
+/**
+ * @brief Install a callback invoked after every successful put.
+ *
+ * The callback runs in the producer's context (possibly an ISR), outside
+ * the queue's critical section. It is used to wake up consumers that do not
+ * poll the queue, e.g. coroutines awaiting a message.
+ *
+ * @param msgq Address of the message queue.
+ * @param notify Callback, or NULL to remove it.
+ * @param user_data Passed back to @a notify.
+ */
+void k_msgq_set_notify(k_msgq_t *msgq, k_msgq_notify_t notify, void *user_data) {
+    k_spinlock_key_t key = k_spin_lock(&msgq->lock);
+    msgq->notify = notify;
+    msgq->notify_data = user_data;
+    k_spin_unlock(&msgq->lock, key);
+}
+
 #endif
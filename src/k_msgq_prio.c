@@ -0,0 +1,181 @@
+/*
+ * @Date: 2026-10-19 23:05:12
+ * @FilePath: \Openy_Framework\src\k_msgq_prio.c
+ * @Description: Message queue with priority bands sharing one slot pool
+ *
+ * Each band is a FIFO of slot indices linked through next[], free slots
+ * are chained through the same array. The ready bitmap holds one bit per
+ * non-empty band, so get finds the most urgent band with a single
+ * count-trailing-zeros whatever the number of queued messages.
+ */
+#include "k_kernel.h"
+
+#ifdef K_CONFIG_MSGQ
+
+/**
+ * @brief Initialize a priority-band message queue.
+ *
+ * @param msgq Address of the message queue.
+ * @param buffer Slot storage, @a msg_size * @a max_msgs bytes.
+ * @param next Slot links, @a max_msgs entries.
+ * @param msg_size Message size (in bytes).
+ * @param max_msgs Number of slots shared by all bands.
+ *
+ * @retval 0 on success
+ * @retval -EINVAL @a max_msgs collides with K_MSGQ_PRIO_NONE
+ */
+int k_msgq_prio_init(k_msgq_prio_t *msgq, char *buffer, uint16_t *next, size_t msg_size,
+                     uint16_t max_msgs) {
+    if (max_msgs >= K_MSGQ_PRIO_NONE) {
+        return -EINVAL;
+    }
+
+    msgq->msg_size = msg_size;
+    msgq->max_msgs = max_msgs;
+    msgq->buffer = buffer;
+    msgq->next = next;
+    msgq->free_head = K_MSGQ_PRIO_NONE;
+    msgq->fresh = 0;
+    for (int i = 0; i < K_CONFIG_MSGQ_PRIO_BANDS; i++) {
+        msgq->used[i] = 0;
+        msgq->limit[i] = 0;
+    }
+    msgq->ready = 0;
+    msgq->lock = (struct k_spinlock){0};
+
+    return 0;
+}
+
+/**
+ * @brief Cap the number of messages a band may hold.
+ *
+ * Keeps a flood on one band from exhausting the slots shared with the
+ * others.
+ *
+ * @param msgq Address of the message queue.
+ * @param band Band index.
+ * @param limit Max messages in @a band, 0 for no limit but the pool size.
+ *
+ * @retval 0 on success
+ * @retval -EINVAL bad band
+ */
+int k_msgq_prio_set_limit(k_msgq_prio_t *msgq, uint8_t band, uint16_t limit) {
+    if (band >= K_CONFIG_MSGQ_PRIO_BANDS) {
+        return -EINVAL;
+    }
+    k_spinlock_key_t key = k_spin_lock(&msgq->lock);
+    msgq->limit[band] = limit;
+    k_spin_unlock(&msgq->lock, key);
+    return 0;
+}
+
+/**
+ * @brief Put a message on a band.
+ *
+ * @funcprops \isr_ok
+ *
+ * @param msgq Address of the message queue.
+ * @param band Band index, 0 is the most urgent.
+ * @param data Message to copy.
+ *
+ * @retval 0 on success
+ * @retval -EINVAL bad band
+ * @retval -ENOMEM band limit reached or no free slot
+ */
+int k_msgq_prio_put(k_msgq_prio_t *msgq, uint8_t band, const void *data) {
+    uint16_t slot;
+    int result = -ENOMEM;
+
+    if (band >= K_CONFIG_MSGQ_PRIO_BANDS) {
+        return -EINVAL;
+    }
+
+    /* lock */
+    k_spinlock_key_t key = k_spin_lock(&msgq->lock);
+
+    if (msgq->limit[band] == 0U || msgq->used[band] < msgq->limit[band]) {
+        slot = msgq->free_head;
+        if (slot != K_MSGQ_PRIO_NONE) {
+            msgq->free_head = msgq->next[slot];
+        } else if (msgq->fresh < msgq->max_msgs) {
+            slot = msgq->fresh++;
+        }
+
+        if (slot != K_MSGQ_PRIO_NONE) {
+            (void)K_MEMCPY(msgq->buffer + slot * msgq->msg_size, data, msgq->msg_size);
+            msgq->next[slot] = K_MSGQ_PRIO_NONE;
+            if (msgq->used[band] == 0U) {
+                msgq->head[band] = slot;
+                msgq->ready |= BIT(band);
+            } else {
+                msgq->next[msgq->tail[band]] = slot;
+            }
+            msgq->tail[band] = slot;
+            msgq->used[band]++;
+            result = 0;
+        }
+    }
+
+    /* unlock */
+    k_spin_unlock(&msgq->lock, key);
+
+    return result;
+}
+
+/**
+ * @brief Get the oldest message of the most urgent non-empty band.
+ *
+ * @funcprops \isr_ok
+ *
+ * @param msgq Address of the message queue.
+ * @param data Area for the message.
+ * @param band Area for the band the message came from, can be NULL.
+ *
+ * @retval 0 on success
+ * @retval -EINVAL all bands are empty
+ */
+int k_msgq_prio_get(k_msgq_prio_t *msgq, void *data, uint8_t *band) {
+    int result = -EINVAL;
+
+    /* lock */
+    k_spinlock_key_t key = k_spin_lock(&msgq->lock);
+
+    if (msgq->ready != 0U) {
+        uint8_t b = (uint8_t)__builtin_ctz(msgq->ready);
+        uint16_t slot = msgq->head[b];
+
+        (void)K_MEMCPY(data, msgq->buffer + slot * msgq->msg_size, msgq->msg_size);
+        msgq->head[b] = msgq->next[slot];
+        if (--msgq->used[b] == 0U) {
+            msgq->ready &= ~BIT(b);
+        }
+
+        msgq->next[slot] = msgq->free_head;
+        msgq->free_head = slot;
+
+        if (band != NULL) {
+            *band = b;
+        }
+        result = 0;
+    }
+
+    /* unlock */
+    k_spin_unlock(&msgq->lock, key);
+
+    return result;
+}
+
+void k_msgq_prio_purge(k_msgq_prio_t *msgq) {
+    /* lock */
+    k_spinlock_key_t key = k_spin_lock(&msgq->lock);
+    msgq->free_head = K_MSGQ_PRIO_NONE;
+    msgq->fresh = 0;
+    for (int i = 0; i < K_CONFIG_MSGQ_PRIO_BANDS; i++) {
+        msgq->used[i] = 0;
+    }
+    msgq->ready = 0;
+    /* unlock */
+    k_spin_unlock(&msgq->lock, key);
+}
+
+#endif // K_CONFIG_MSGQ
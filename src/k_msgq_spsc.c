@@ -0,0 +1,125 @@
+/*
+ * @Date: 2026-10-19 21:48:03
+ * @FilePath: \Openy_Framework\src\k_msgq_spsc.c
+ * @Description: Lock-free single-producer/single-consumer message queue
+ *
+ * The producer owns head and the consumer owns tail, each side only reads
+ * the other's index, so no interrupt masking is needed. Indices run modulo
+ * 2 * max_msgs (free running with a power-of-two size), which tells full
+ * from empty without sacrificing a slot.
+ */
+#include "k_kernel.h"
+
+#ifdef K_CONFIG_MSGQ
+
+static inline uint32_t spsc_used(const k_msgq_spsc_t *msgq, uint32_t head, uint32_t tail) {
+    if (msgq->mask != 0U || head >= tail) {
+        return head - tail;
+    }
+    return head + 2U * msgq->max_msgs - tail;
+}
+
+static inline char *spsc_slot(const k_msgq_spsc_t *msgq, uint32_t idx) {
+    if (msgq->mask != 0U) {
+        idx &= msgq->mask;
+    } else if (idx >= msgq->max_msgs) {
+        idx -= msgq->max_msgs;
+    }
+    return msgq->buffer + idx * msgq->msg_size;
+}
+
+static inline uint32_t spsc_next(const k_msgq_spsc_t *msgq, uint32_t idx) {
+    idx++;
+    if (msgq->mask == 0U && idx == 2U * msgq->max_msgs) {
+        idx = 0U;
+    }
+    return idx;
+}
+
+void k_msgq_spsc_init(k_msgq_spsc_t *msgq, char *buffer, size_t msg_size, uint32_t max_msgs) {
+    msgq->msg_size = msg_size;
+    msgq->max_msgs = max_msgs;
+    msgq->mask = K_MSGQ_SPSC_IS_POW2(max_msgs) ? (max_msgs - 1U) : 0U;
+    msgq->buffer = buffer;
+    msgq->head = 0;
+    msgq->tail = 0;
+}
+
+/**
+ * @brief Put a message, producer side only.
+ *
+ * @funcprops \isr_ok
+ *
+ * @retval 0 on success
+ * @retval -ENOMEM if the queue is full
+ */
+int k_msgq_spsc_put(k_msgq_spsc_t *msgq, const void *data) {
+    uint32_t head = (uint32_t)msgq->head;
+    uint32_t tail = (uint32_t)atomic_get(&msgq->tail);
+
+    if (spsc_used(msgq, head, tail) >= msgq->max_msgs) {
+        return -ENOMEM;
+    }
+
+    (void)K_MEMCPY(spsc_slot(msgq, head), data, msgq->msg_size);
+    /* publish the slot only once the copy is complete */
+    (void)atomic_set(&msgq->head, (atomic_t)spsc_next(msgq, head));
+
+    return 0;
+}
+
+/**
+ * @brief Get a message, consumer side only.
+ *
+ * @funcprops \isr_ok
+ *
+ * @retval 0 on success
+ * @retval -EINVAL if the queue is empty
+ */
+int k_msgq_spsc_get(k_msgq_spsc_t *msgq, void *data) {
+    uint32_t tail = (uint32_t)msgq->tail;
+    uint32_t head = (uint32_t)atomic_get(&msgq->head);
+
+    if (head == tail) {
+        return -EINVAL;
+    }
+
+    (void)K_MEMCPY(data, spsc_slot(msgq, tail), msgq->msg_size);
+    /* hand the slot back to the producer once it has been read */
+    (void)atomic_set(&msgq->tail, (atomic_t)spsc_next(msgq, tail));
+
+    return 0;
+}
+
+/**
+ * @brief Read the oldest message without removing it, consumer side only.
+ *
+ * @retval 0 on success
+ * @retval -EINVAL if the queue is empty
+ */
+int k_msgq_spsc_peek(k_msgq_spsc_t *msgq, void *data) {
+    uint32_t tail = (uint32_t)msgq->tail;
+    uint32_t head = (uint32_t)atomic_get(&msgq->head);
+
+    if (head == tail) {
+        return -EINVAL;
+    }
+
+    (void)K_MEMCPY(data, spsc_slot(msgq, tail), msgq->msg_size);
+
+    return 0;
+}
+
+/**
+ * @brief Number of messages in the queue.
+ *
+ * Exact from either side, a snapshot from anywhere else.
+ */
+uint32_t k_msgq_spsc_num_used_get(k_msgq_spsc_t *msgq) {
+    uint32_t tail = (uint32_t)atomic_get(&msgq->tail);
+    uint32_t head = (uint32_t)atomic_get(&msgq->head);
+
+    return spsc_used(msgq, head, tail);
+}
+
+#endif // K_CONFIG_MSGQ
@@ -16,6 +16,27 @@ struct alloc_node {
     void *data;
 };
 
+#ifdef K_CONFIG_KERNEL_MEM_SLAB
+K_MEM_SLAB_DEFINE(sQueueNodeSlab, sizeof(struct alloc_node), K_CONFIG_QUEUE_ALLOC_NODES,
+                  sizeof(void *));
+
+static inline struct alloc_node *queue_node_alloc(void) {
+    void *mem;
+
+    return (k_mem_slab_alloc(&sQueueNodeSlab, &mem) == 0) ? (struct alloc_node *)mem : NULL;
+}
+
+static inline void queue_node_free(struct alloc_node *anode) {
+    k_mem_slab_free(&sQueueNodeSlab, anode);
+}
+#else
+static inline struct alloc_node *queue_node_alloc(void) {
+    return (struct alloc_node *)K_MALLOC(sizeof(struct alloc_node));
+}
+
+static inline void queue_node_free(struct alloc_node *anode) { K_FREE(anode); }
+#endif // K_CONFIG_KERNEL_MEM_SLAB
+
 void *z_queue_node_peek(sys_sfnode_t *node, bool needs_free) {
     void *ret;
 
@@ -30,7 +51,7 @@ void *z_queue_node_peek(sys_sfnode_t *node, bool needs_free) {
         anode = CONTAINER_OF(node, struct alloc_node, node);
         ret = anode->data;
         if (needs_free) {
-            K_FREE(anode);
+            queue_node_free(anode);
         }
     } else {
         /* Data was directly placed in the queue, the first word
@@ -56,7 +77,7 @@ void *z_queue_node_peek(sys_sfnode_t *node, bool needs_free) {
  */
 static int32_t queue_insert(k_queue_t *queue, void *prev, void *data, bool alloc, bool is_append) {
     
-    queue->lock = k_interrupt_disable();
+    k_spinlock_key_t key = k_spin_lock(&queue->lock);
     
     if (is_append) {
         prev = sys_sflist_peek_tail(&queue->data_q);
@@ -66,9 +87,10 @@ static int32_t queue_insert(k_queue_t *queue, void *prev, void *data, bool alloc
     if (alloc) {
         struct alloc_node *anode;
 
-        anode = K_MALLOC(sizeof(*anode));
+        anode = queue_node_alloc();
         if (anode == NULL) {
-            k_interrupt_enable(queue->lock);
+            K_OBJ_STATS_PUT(&queue->stats, K_OBJ_STATS_QUEUE, 0, 1, queue->stats.used, 0);
+            k_spin_unlock(&queue->lock, key);
             return -ENOMEM;
         }
         anode->data = data;
@@ -79,8 +101,9 @@ static int32_t queue_insert(k_queue_t *queue, void *prev, void *data, bool alloc
     }
 
     sys_sflist_insert(&queue->data_q, prev, data);
-    
-    k_interrupt_enable(queue->lock);
+    K_OBJ_STATS_PUT(&queue->stats, K_OBJ_STATS_QUEUE, 1, 0, queue->stats.used + 1U, 0);
+
+    k_spin_unlock(&queue->lock, key);
 
     return 0;
 }
@@ -99,8 +122,9 @@ static int32_t queue_insert(k_queue_t *queue, void *prev, void *data, bool alloc
  * @param queue Address of the queue.
  */
 void k_queue_init(k_queue_t *queue) { 
-    queue->lock = 0;
-    sys_sflist_init(&queue->data_q); 
+    queue->lock = (struct k_spinlock){0};
+    sys_sflist_init(&queue->data_q);
+    K_OBJ_STATS_INIT(&queue->stats, K_OBJ_STATS_QUEUE, 0);
 }
 
 /**
@@ -216,6 +240,45 @@ int32_t k_queue_alloc_prepend(k_queue_t *queue, void *data) {
     return ret;
 }
 
+/**
+ * @brief Append a chain of items to a queue in one critical section.
+ *
+ * The chain is NULL-terminated and linked through the first word of each
+ * item, as the items of k_queue_append(). The items are not copied.
+ *
+ * @funcprops \isr_ok
+ *
+ * @param queue Address of the queue.
+ * @param head First item of the chain.
+ * @param tail Last item of the chain.
+ *
+ * @retval 0 on success
+ * @retval -EINVAL @a head or @a tail is NULL
+ */
+int k_queue_append_list(k_queue_t *queue, void *head, void *tail) {
+    uint32_t count = 0;
+
+#ifdef K_CONFIG_OBJ_STATS
+    for (sys_sfnode_t *node = head; node != NULL; node = sys_sflist_peek_next(node)) {
+        count++;
+        if (node == tail) {
+            break;
+        }
+    }
+#endif
+
+    if (head == NULL || tail == NULL) {
+        return -EINVAL;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&queue->lock);
+    sys_sflist_append_list(&queue->data_q, head, tail);
+    K_OBJ_STATS_PUT(&queue->stats, K_OBJ_STATS_QUEUE, count, 0, queue->stats.used + count, 0);
+    k_spin_unlock(&queue->lock, key);
+
+    return 0;
+}
+
 /**
  * @brief Get an element from a queue.
  *
@@ -237,17 +300,59 @@ int32_t k_queue_alloc_prepend(k_queue_t *queue, void *data) {
 void *k_queue_get(k_queue_t *queue) {
     void *data = NULL;
 
-    queue->lock = k_interrupt_disable();
+    k_spinlock_key_t key = k_spin_lock(&queue->lock);
     if (!sys_sflist_is_empty(&queue->data_q)) {
         sys_sfnode_t *node;
 
         node = sys_sflist_get_not_empty(&queue->data_q);
         data = z_queue_node_peek(node, true);
+        K_OBJ_STATS_GET(&queue->stats, 1, queue->stats.used - 1U);
     }
-    k_interrupt_enable(queue->lock);
+    k_spin_unlock(&queue->lock, key);
     return data;
 }
 
+/**
+ * @brief Detach all elements of a queue in one critical section.
+ *
+ * The elements are moved to @a list, which the caller then drains with
+ * k_queue_list_get() without any locking, e.g. a consumer handling a burst
+ * of 100 items masks interrupts once instead of 100 times.
+ *
+ * @funcprops \isr_ok
+ *
+ * @param queue Address of the queue.
+ * @param list Local list receiving the elements, its previous content is
+ *        discarded.
+ *
+ * @return true if any element was detached.
+ */
+bool k_queue_get_all(k_queue_t *queue, sys_sflist_t *list) {
+    sys_sflist_init(list);
+
+    k_spinlock_key_t key = k_spin_lock(&queue->lock);
+    sys_sflist_merge_sflist(list, &queue->data_q);
+    K_OBJ_STATS_GET(&queue->stats, queue->stats.used, 0);
+    k_spin_unlock(&queue->lock, key);
+
+    return !sys_sflist_is_empty(list);
+}
+
+/**
+ * @brief Get the next element of a list filled by k_queue_get_all().
+ *
+ * Takes care of the bookkeeping nodes of k_queue_alloc_*() items like
+ * k_queue_get() does. The list is private to the caller so no lock is
+ * taken.
+ *
+ * @param list List filled by k_queue_get_all().
+ *
+ * @return Address of the data item, NULL once the list is empty.
+ */
+void *k_queue_list_get(sys_sflist_t *list) {
+    return z_queue_node_peek(sys_sflist_get(list), true);
+}
+
 /**
  * @brief Remove an element from a queue.
  *
@@ -265,7 +370,13 @@ void *k_queue_get(k_queue_t *queue) {
  * @return true if data item was removed
  */
 bool k_queue_remove(k_queue_t *queue, void *data) {
+    k_spinlock_key_t key = k_spin_lock(&queue->lock);
     bool ret = sys_sflist_find_and_remove(&queue->data_q, (sys_sfnode_t *)data);
+
+    if (ret) {
+        K_OBJ_STATS_GET(&queue->stats, 1, queue->stats.used - 1U);
+    }
+    k_spin_unlock(&queue->lock, key);
     return ret;
 }
 
@@ -294,7 +405,10 @@ int k_queue_is_empty(k_queue_t *queue) { return (int)sys_sflist_is_empty(&queue-
  * @return Head element, or NULL if queue is empty.
  */
 void *k_queue_peek_head(k_queue_t *queue) {
+    k_spinlock_key_t key = k_spin_lock(&queue->lock);
     void *ret = z_queue_node_peek(sys_sflist_peek_head(&queue->data_q), false);
+
+    k_spin_unlock(&queue->lock, key);
     return ret;
 }
 
@@ -308,7 +422,10 @@ void *k_queue_peek_head(k_queue_t *queue) {
  * @return Tail element, or NULL if queue is empty.
  */
 void *k_queue_peek_tail(k_queue_t *queue) {
+    k_spinlock_key_t key = k_spin_lock(&queue->lock);
     void *ret = z_queue_node_peek(sys_sflist_peek_tail(&queue->data_q), false);
+
+    k_spin_unlock(&queue->lock, key);
     return ret;
 }
 
@@ -50,6 +50,10 @@ int ring_buf_put_finish(struct ring_buf *buf, uint32_t size) {
         buf->put_base += buf->size;
     }
 
+    if (size > 0U) {
+        K_OBJ_STATS_PUT(&buf->stats, K_OBJ_STATS_RING_BUF, 1, 0, ring_buf_size_get(buf), buf->size);
+    }
+
     return 0;
 }
 
@@ -71,6 +75,11 @@ uint32_t ring_buf_put(struct ring_buf *buf, const uint8_t *data, uint32_t size)
     __ASSERT_NO_MSG(err == 0);
     ARG_UNUSED(err);
 
+    if (size > 0U) {
+        /* truncated write */
+        K_OBJ_STATS_PUT(&buf->stats, K_OBJ_STATS_RING_BUF, 0, 1, ring_buf_size_get(buf), buf->size);
+    }
+
     return total_size;
 }
 
@@ -114,6 +123,10 @@ int ring_buf_get_finish(struct ring_buf *buf, uint32_t size) {
         buf->get_base += buf->size;
     }
 
+    if (size > 0U) {
+        K_OBJ_STATS_GET(&buf->stats, 1, ring_buf_size_get(buf));
+    }
+
     return 0;
 }
 
@@ -187,6 +200,7 @@ int ring_buf_item_put(struct ring_buf *buf, uint16_t type, uint8_t value, uint32
     space = ring_buf_space_get(buf);
     size = size32 * 4;
     if (size + sizeof(struct ring_element) > space) {
+        K_OBJ_STATS_PUT(&buf->stats, K_OBJ_STATS_RING_BUF, 0, 1, ring_buf_size_get(buf), buf->size);
         return -EINVAL;
     }
 
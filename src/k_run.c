@@ -0,0 +1,287 @@
+/*
+ * @Date: 2026-10-19 21:02:15
+ * @FilePath: \Openy_Framework\src\k_run.c
+ * @Description: Event-driven run loop
+ *
+ * Producers only set a ready bit (from k_msgq_put(), k_mevt_post() or
+ * k_work_user_submit(), ISR included). k_run() dispatches the highest
+ * priority ready source for at most its budget, then re-evaluates the
+ * bitmap, and sleeps in k_cpu_atomic_idle() when nothing is ready.
+ *
+ * Every core has its own sources, ready bits and message scratch area, so
+ * each core may run its own k_run() with its own priorities. A source
+ * belongs to the core that added it; a producer on another core sets the
+ * bit of that core, which sees it at the latest on its next interrupt.
+ */
+#include "k_run.h"
+
+#ifdef K_CONFIG_RUN
+
+/* Run loop state of one core */
+struct run_cpu {
+    k_run_src_t *sources[K_RUN_MAX_SOURCES];
+    atomic_t ready;
+    struct k_spinlock lock;
+    /* Scratch area for msgq sources, dispatch only happens from k_run() */
+    union {
+        uint32_t align;
+        char data[K_CONFIG_RUN_MSG_SIZE_MAX];
+    } msg_buf;
+};
+
+static struct run_cpu sRunCpu[Z_NUM_CPUS];
+
+#ifdef K_CONFIG_SMP
+#define RUN_SRC_CPU(src) ((int)(src)->cpu)
+#else
+#define RUN_SRC_CPU(src) 0
+#endif
+
+/**
+ * @brief Mark the source at @a prio of the calling core ready.
+ *
+ * @funcprops \isr_ok
+ */
+void k_run_signal(uint8_t prio) {
+    (void)atomic_test_and_set_bit(&sRunCpu[k_cpu_id()].ready, prio);
+}
+
+/* Producers may run on any core, the bit goes to the owner of @a src */
+static void run_src_signal(k_run_src_t *src) {
+    (void)atomic_test_and_set_bit(&sRunCpu[RUN_SRC_CPU(src)].ready, src->prio);
+}
+
+static void run_msgq_notify(k_msgq_t *msgq, void *user_data) {
+    ARG_UNUSED(msgq);
+    run_src_signal((k_run_src_t *)user_data);
+}
+
+static void run_work_notify(void *user_data) {
+    run_src_signal((k_run_src_t *)user_data);
+}
+
+/* @a obj is the k_msgq_t or k_hsm_t of the source, NULL for the work queue */
+static int run_add(k_run_src_t *src, uint8_t type, uint8_t prio, uint16_t budget, void *obj,
+                   k_run_msg_handler_t handler) {
+    struct run_cpu *rc = &sRunCpu[k_cpu_id()];
+    int ret = 0;
+
+    if (prio >= K_RUN_MAX_SOURCES || budget == 0U) {
+        return -EINVAL;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&rc->lock);
+    if (rc->sources[prio] != NULL) {
+        ret = -EBUSY;
+    } else {
+        /* only once the slot is ours, a rejected @a src keeps its place */
+        src->type = type;
+        src->prio = prio;
+        src->budget = budget;
+        if (type == K_RUN_SRC_HSM) {
+            src->obj.hsm = (k_hsm_t *)obj;
+        } else {
+            src->obj.msgq = (k_msgq_t *)obj;
+        }
+        src->handler = handler;
+#ifdef K_CONFIG_SMP
+        src->cpu = (uint8_t)k_cpu_id();
+#endif
+        rc->sources[prio] = src;
+    }
+    k_spin_unlock(&rc->lock, key);
+
+    return ret;
+}
+
+/**
+ * @brief Register the calling core's work queue as a run loop source.
+ *
+ * @param src Source storage, must stay valid while registered.
+ * @param prio Priority, 0 is the highest. Unique per source on a core.
+ * @param budget Max work items run per dispatch.
+ *
+ * @retval 0 on success
+ * @retval -EINVAL bad priority or budget
+ * @retval -EBUSY priority already in use on the calling core
+ */
+int k_run_add_workq(k_run_src_t *src, uint8_t prio, uint16_t budget) {
+    int ret = run_add(src, K_RUN_SRC_WORKQ, prio, budget, NULL, NULL);
+
+    if (ret == 0) {
+        k_work_user_set_notify(run_work_notify, src);
+        /* items may have been submitted before registration */
+        run_src_signal(src);
+    }
+    return ret;
+}
+
+/**
+ * @brief Register a message queue consumer as a run loop source.
+ *
+ * Takes over the queue's notify callback. @a handler is called once per
+ * message with a copy of it, the copy is only valid during the call.
+ *
+ * @param src Source storage, must stay valid while registered.
+ * @param prio Priority, 0 is the highest. Unique per source on a core.
+ * @param budget Max messages handled per dispatch.
+ * @param msgq Message queue, msg_size <= K_CONFIG_RUN_MSG_SIZE_MAX.
+ * @param handler Message handler.
+ *
+ * @retval 0 on success
+ * @retval -EINVAL bad priority, budget or message size
+ * @retval -EBUSY priority already in use on the calling core
+ */
+int k_run_add_msgq(k_run_src_t *src, uint8_t prio, uint16_t budget, k_msgq_t *msgq,
+                   k_run_msg_handler_t handler) {
+    if (msgq->msg_size > K_CONFIG_RUN_MSG_SIZE_MAX || handler == NULL) {
+        return -EINVAL;
+    }
+
+    int ret = run_add(src, K_RUN_SRC_MSGQ, prio, budget, msgq, handler);
+
+    if (ret == 0) {
+        k_msgq_set_notify(msgq, run_msgq_notify, src);
+        run_src_signal(src);
+    }
+    return ret;
+}
+
+/**
+ * @brief Register a hierarchical state machine as a run loop source.
+ *
+ * The HSM must be initialized, events posted with k_mevt_post() are then
+ * dispatched from k_run().
+ *
+ * @param src Source storage, must stay valid while registered.
+ * @param prio Priority, 0 is the highest. Unique per source on a core.
+ * @param budget Max events dispatched per dispatch.
+ * @param hsm State machine.
+ *
+ * @retval 0 on success
+ * @retval -EINVAL bad priority or budget
+ * @retval -EBUSY priority already in use on the calling core
+ */
+int k_run_add_hsm(k_run_src_t *src, uint8_t prio, uint16_t budget, k_hsm_t *hsm) {
+    int ret = run_add(src, K_RUN_SRC_HSM, prio, budget, hsm, NULL);
+
+    if (ret == 0) {
+        k_msgq_set_notify(&hsm->eQueue, run_msgq_notify, src);
+        run_src_signal(src);
+    }
+    return ret;
+}
+
+/**
+ * @brief Unregister a source.
+ *
+ * Call it on the core that added @a src.
+ */
+void k_run_remove(k_run_src_t *src) {
+    struct run_cpu *rc = &sRunCpu[RUN_SRC_CPU(src)];
+
+    switch (src->type) {
+    case K_RUN_SRC_WORKQ: k_work_user_set_notify(NULL, NULL); break;
+    case K_RUN_SRC_MSGQ: k_msgq_set_notify(src->obj.msgq, NULL, NULL); break;
+    case K_RUN_SRC_HSM: k_msgq_set_notify(&src->obj.hsm->eQueue, NULL, NULL); break;
+    default: break;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&rc->lock);
+    if (rc->sources[src->prio] == src) {
+        rc->sources[src->prio] = NULL;
+    }
+    k_spin_unlock(&rc->lock, key);
+    atomic_clear_bit(&rc->ready, src->prio);
+}
+
+/* Handle one item, returns false once the source is drained */
+static bool run_dispatch_one(struct run_cpu *rc, k_run_src_t *src) {
+    switch (src->type) {
+    case K_RUN_SRC_WORKQ: return k_work_user_wait() == 0;
+
+    case K_RUN_SRC_MSGQ:
+        if (k_msgq_get(src->obj.msgq, rc->msg_buf.data) != 0) {
+            return false;
+        }
+        K_LOAD_ENTER(load, K_LOAD_MSGQ);
+        src->handler(src->obj.msgq, rc->msg_buf.data);
+        K_LOAD_EXIT(load);
+        return true;
+
+    case K_RUN_SRC_HSM: {
+        k_mevt_t const *e = k_mevt_get(src->obj.hsm);
+        if (e == NULL) {
+            return false;
+        }
+        src->obj.hsm->super.dispatch(&src->obj.hsm->super, e);
+        return true;
+    }
+
+    default: return false;
+    }
+}
+
+/**
+ * @brief Dispatch the highest priority ready source of the calling core once.
+ *
+ * @return false if no source was ready.
+ */
+bool k_run_once(void) {
+    struct run_cpu *rc = &sRunCpu[k_cpu_id()];
+    atomic_t ready = atomic_get(&rc->ready);
+
+    if (ready == 0) {
+        return false;
+    }
+
+    uint8_t prio = (uint8_t)__builtin_ctzl((unsigned long)ready);
+    k_run_src_t *src = rc->sources[prio];
+
+    /* clear before draining, so a put racing with us re-arms the bit */
+    atomic_clear_bit(&rc->ready, prio);
+    if (src == NULL) {
+        return true;
+    }
+
+    uint16_t n;
+    for (n = 0; n < src->budget; n++) {
+        if (!run_dispatch_one(rc, src)) {
+            break;
+        }
+    }
+
+    if (n == src->budget) {
+        /* budget exhausted, there may be more: come back after higher priorities */
+        run_src_signal(src);
+    }
+    return true;
+}
+
+/**
+ * @brief Run the dispatch loop of the calling core forever.
+ */
+void k_run(void) {
+    struct run_cpu *rc = &sRunCpu[k_cpu_id()];
+
+    for (;;) {
+        if (!k_run_once()) {
+#ifdef K_CONFIG_LOG_DEFERRED
+            /* one line at a time, sources made ready meanwhile go first */
+            if (k_log_process()) {
+                continue;
+            }
+#endif
+            atomic_t key = k_interrupt_disable();
+            if (atomic_get(&rc->ready) == 0) {
+                K_LOAD_ENTER(load, K_LOAD_IDLE);
+                k_cpu_atomic_idle(key);
+                K_LOAD_EXIT(load);
+            } else {
+                k_interrupt_enable(key);
+            }
+        }
+    }
+}
+
+#endif // K_CONFIG_RUN
@@ -0,0 +1,162 @@
+/*
+ * @Date: 2026-10-20 09:14:26
+ * @FilePath: \Openy_Framework\src\k_stats.c
+ * @Description: Occupancy and drop statistics for k_msgq, k_queue and ring_buf
+ *
+ * Objects join the registry on their first put (or explicitly through
+ * k_obj_stats_register() to give them a name), so statically defined
+ * queues need no extra call to show up in k_obj_stats_foreach().
+ */
+#include "k_kernel.h"
+
+#ifdef K_CONFIG_OBJ_STATS
+
+static struct k_obj_stats *sStatsList = NULL;
+/* Guards the registry and every counter block: the hooks run under the
+ * objects' own locks, which differ from object to object
+ */
+static struct k_spinlock sStatsLock;
+
+static bool stats_is_listed(struct k_obj_stats *stats) {
+    struct k_obj_stats *s;
+
+    for (s = sStatsList; s != NULL; s = s->next) {
+        if (s == stats) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void stats_link(struct k_obj_stats *stats, uint8_t type) {
+    stats->type = type;
+    stats->next = sStatsList;
+    sStatsList = stats;
+    stats->registered = true;
+}
+
+static void stats_clear(struct k_obj_stats *stats) {
+    stats->full = false;
+    stats->used = 0;
+    stats->high_water = 0;
+    stats->puts = 0;
+    stats->gets = 0;
+    stats->put_fails = 0;
+    stats->full_since = 0;
+    stats->full_ticks = 0;
+}
+
+static inline void stats_update_level(struct k_obj_stats *stats, uint32_t used) {
+    bool full = stats->capacity != 0U && used >= stats->capacity;
+
+    stats->used = used;
+    if (used > stats->high_water) {
+        stats->high_water = used;
+    }
+    if (full && !stats->full) {
+        stats->full_since = sys_clock_tick_get();
+    } else if (!full && stats->full) {
+        stats->full_ticks += sys_clock_tick_get() - stats->full_since;
+    }
+    stats->full = full;
+}
+
+/**
+ * @brief Add an object to the registry and name it.
+ *
+ * Optional, objects are registered anonymously on their first put.
+ *
+ * @param stats Statistics block of the object, e.g. &msgq->stats.
+ * @param type K_OBJ_STATS_MSGQ, K_OBJ_STATS_QUEUE or K_OBJ_STATS_RING_BUF.
+ * @param name Name reported in snapshots, must stay valid.
+ */
+void k_obj_stats_register(struct k_obj_stats *stats, uint8_t type, const char *name) {
+    k_spinlock_key_t key = k_spin_lock(&sStatsLock);
+    if (!stats->registered) {
+        stats_link(stats, type);
+    }
+    stats->name = name;
+    k_spin_unlock(&sStatsLock, key);
+}
+
+/**
+ * @brief Restart the counters of an object.
+ *
+ * The high-water mark restarts from the current occupancy.
+ */
+void k_obj_stats_reset(struct k_obj_stats *stats) {
+    k_spinlock_key_t key = k_spin_lock(&sStatsLock);
+    uint32_t used = stats->used;
+
+    stats_clear(stats);
+    stats_update_level(stats, used);
+    k_spin_unlock(&sStatsLock, key);
+}
+
+/**
+ * @brief Call @a cb with a consistent snapshot of every registered object.
+ *
+ * Each snapshot is copied under the registry lock, @a cb itself runs with
+ * interrupts enabled. For an object that is currently full, full_ticks
+ * includes the ongoing period.
+ */
+void k_obj_stats_foreach(k_obj_stats_cb_t cb, void *user_data) {
+    struct k_obj_stats snapshot;
+    struct k_obj_stats *s;
+    k_spinlock_key_t key;
+
+    key = k_spin_lock(&sStatsLock);
+    s = sStatsList;
+    k_spin_unlock(&sStatsLock, key);
+
+    while (s != NULL) {
+        key = k_spin_lock(&sStatsLock);
+        snapshot = *s;
+        if (snapshot.full) {
+            snapshot.full_ticks += sys_clock_tick_get() - snapshot.full_since;
+        }
+        s = s->next;
+        k_spin_unlock(&sStatsLock, key);
+
+        cb(&snapshot, user_data);
+    }
+}
+
+void z_obj_stats_init(struct k_obj_stats *stats, uint8_t type, uint32_t capacity) {
+    k_spinlock_key_t key = k_spin_lock(&sStatsLock);
+
+    /* the block may hold garbage if the object was never initialized */
+    if (!stats_is_listed(stats)) {
+        stats->registered = false;
+        stats->next = NULL;
+        stats->name = NULL;
+    }
+    stats->type = type;
+    stats->capacity = capacity;
+    stats_clear(stats);
+    k_spin_unlock(&sStatsLock, key);
+}
+
+void z_obj_stats_put(struct k_obj_stats *stats, uint8_t type, uint32_t n_ok, uint32_t n_fail,
+                     uint32_t used, uint32_t capacity) {
+    k_spinlock_key_t key = k_spin_lock(&sStatsLock);
+
+    if (!stats->registered) {
+        stats_link(stats, type);
+    }
+    stats->capacity = capacity;
+    stats->puts += n_ok;
+    stats->put_fails += n_fail;
+    stats_update_level(stats, used);
+    k_spin_unlock(&sStatsLock, key);
+}
+
+void z_obj_stats_get(struct k_obj_stats *stats, uint32_t n, uint32_t used) {
+    k_spinlock_key_t key = k_spin_lock(&sStatsLock);
+
+    stats->gets += n;
+    stats_update_level(stats, used);
+    k_spin_unlock(&sStatsLock, key);
+}
+
+#endif // K_CONFIG_OBJ_STATS
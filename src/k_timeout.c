@@ -10,12 +10,22 @@
 #define INT_MAX 0x7FFFFFFF
 #endif
 
-static sys_dlist_t sTimeoutList = SYS_DLIST_STATIC_INIT(&sTimeoutList);
-static atomic_t sTimeoutLock = 0;
-static int sAnnounceRemaining = 0;
-static k_ticks_t sCurrTick = 0;
+/* Each core keeps its own list, announced by its own tick driver, so timers
+ * started on a core fire there and never contend with the other cores.
+ */
+struct timeout_cpu {
+    sys_dlist_t list;
+    struct k_spinlock lock;
+    int announce_remaining;
+    k_ticks_t curr_tick;
+};
+
+/* Lists are set up by the first k_timeout_add() of their core, a zeroed
+ * list reads as empty until then
+ */
+static struct timeout_cpu sTimeoutCpu[Z_NUM_CPUS];
 
-static inline int32_t elapsed(void) {
+static inline int32_t elapsed(struct timeout_cpu *tc) {
     /* While sys_clock_announce() is executing, new relative timeouts will be
      * scheduled relatively to the currently firing timeout's original tick
      * value (=curr_tick) rather than relative to the current
@@ -32,29 +42,29 @@ static inline int32_t elapsed(void) {
      * will be non-zero while sys_clock_announce() is executing and zero
      * otherwise.
      */
-    return sAnnounceRemaining == 0 ? sys_clock_elapsed() : 0U;
+    return tc->announce_remaining == 0 ? sys_clock_elapsed() : 0U;
 }
 
-static inline struct _timeout *first(void) {
-    sys_dnode_t *t = sys_dlist_peek_head(&sTimeoutList);
+static inline struct _timeout *first(struct timeout_cpu *tc) {
+    sys_dnode_t *t = sys_dlist_peek_head(&tc->list);
     return t == NULL ? NULL : CONTAINER_OF(t, struct _timeout, node);
 }
 
-static inline struct _timeout *next(struct _timeout *t) {
-    sys_dnode_t *n = sys_dlist_peek_next(&sTimeoutList, &t->node);
+static inline struct _timeout *next(struct timeout_cpu *tc, struct _timeout *t) {
+    sys_dnode_t *n = sys_dlist_peek_next(&tc->list, &t->node);
     return n == NULL ? NULL : CONTAINER_OF(n, struct _timeout, node);
 }
 
-static inline void remove_timeout(struct _timeout *t) {
-    if (next(t) != NULL) {
-        next(t)->dticks += t->dticks;
+static inline void remove_timeout(struct timeout_cpu *tc, struct _timeout *t) {
+    if (next(tc, t) != NULL) {
+        next(tc, t)->dticks += t->dticks;
     }
     sys_dlist_remove(&t->node);
 }
 
-static inline int32_t next_timeout(void) {
-    struct _timeout *to = first();
-    int32_t ticks_elapsed = elapsed();
+static inline int32_t next_timeout(struct timeout_cpu *tc) {
+    struct _timeout *to = first(tc);
+    int32_t ticks_elapsed = elapsed(tc);
     int32_t ret;
 
     if ((to == NULL) || ((int32_t)(to->dticks - ticks_elapsed) > (int32_t)INT_MAX)) {
@@ -65,30 +75,50 @@ static inline int32_t next_timeout(void) {
     return ret;
 }
 
+/**
+ * @brief Cancel a timeout, from any core.
+ */
 int k_timeout_abort(struct _timeout *to) {
+    struct timeout_cpu *tc = &sTimeoutCpu[Z_TIMEOUT_CPU(to)];
+    k_spinlock_key_t key;
     int ret = -EINVAL;
-    sTimeoutLock = k_interrupt_disable();
+
+    key = k_spin_lock(&tc->lock);
     if (sys_dnode_is_linked(&to->node)) {
-        remove_timeout(to);
+        remove_timeout(tc, to);
+        K_TRACE_TIMEOUT_ABORT(to);
         ret = 0;
     }
-    k_interrupt_enable(sTimeoutLock);
+    k_spin_unlock(&tc->lock, key);
     return ret;
 }
 
+/**
+ * @brief Start a timeout on the calling core's list.
+ *
+ * @a fn runs on this core. @a to must not be pending.
+ */
 void k_timeout_add(struct _timeout *to, _timeout_func_t fn, k_timeout_t timeout) {
+    struct timeout_cpu *tc = &sTimeoutCpu[k_cpu_id()];
+    k_spinlock_key_t key;
 
     if (K_TIMEOUT_EQ(timeout, K_FOREVER)) {
         return;
     }
 
-    sTimeoutLock = k_interrupt_disable();
+    key = k_spin_lock(&tc->lock);
+    if (tc->list.head == NULL) {
+        sys_dlist_init(&tc->list);
+    }
 
+#ifdef K_CONFIG_SMP
+    to->cpu = (uint8_t)k_cpu_id();
+#endif
     to->fn = fn;
-    to->dticks = timeout.ticks + 1 + elapsed();
+    to->dticks = timeout.ticks + 1 + elapsed(tc);
 
     struct _timeout *t = NULL;
-    for (t = first(); t != NULL; t = next(t)) {
+    for (t = first(tc); t != NULL; t = next(tc, t)) {
         if (t->dticks > to->dticks) {
             t->dticks -= to->dticks;
             sys_dlist_insert(&t->node, &to->node);
@@ -98,21 +128,26 @@ void k_timeout_add(struct _timeout *to, _timeout_func_t fn, k_timeout_t timeout)
     }
 
     if (t == NULL) {
-        sys_dlist_append(&sTimeoutList, &to->node);
+        sys_dlist_append(&tc->list, &to->node);
     }
+    K_TRACE_TIMEOUT_ADD(to, timeout.ticks);
 
-    if (to == first()) {
-        sys_clock_set_timeout(next_timeout(), false);
+    if (to == first(tc)) {
+        sys_clock_set_timeout(next_timeout(tc), false);
     }
-    k_interrupt_enable(sTimeoutLock);
+    k_spin_unlock(&tc->lock, key);
 }
 
+/**
+ * @brief Ticks announced so far on the calling core.
+ */
 k_ticks_t sys_clock_tick_get(void) {
-	return sCurrTick;
+	return sTimeoutCpu[k_cpu_id()].curr_tick;
 }
 
 /**
- * @description: It can only run in a timer ISR
+ * @description: It can only run in a timer ISR, on SMP in the tick ISR of
+ * each core, which fires that core's timeouts
  * 
  * Informs the kernel that the specified number of ticks have elapsed
  * since the last call to sys_clock_announce() (or system startup for
@@ -124,30 +159,37 @@ k_ticks_t sys_clock_tick_get(void) {
  * @return {*}
  */
 void sys_clock_announce(int32_t ticks) {
+    struct timeout_cpu *tc = &sTimeoutCpu[k_cpu_id()];
     struct _timeout *t;
-    sTimeoutLock = k_interrupt_disable();
-    sAnnounceRemaining = ticks;
-    for (t = first(); t && t->dticks <= sAnnounceRemaining; t = first()) {
+    k_spinlock_key_t key;
+    K_LOAD_ENTER(load, K_LOAD_TIMER);
+
+    key = k_spin_lock(&tc->lock);
+    tc->announce_remaining = ticks;
+    for (t = first(tc); t && t->dticks <= tc->announce_remaining; t = first(tc)) {
         int dt = t->dticks;
         
-        sCurrTick += dt;
+        tc->curr_tick += dt;
         t->dticks = 0;
-        remove_timeout(t);
-        k_interrupt_enable(sTimeoutLock);
+        remove_timeout(tc, t);
+        k_spin_unlock(&tc->lock, key);
+        K_TRACE_TIMEOUT_EXPIRE(t);
         t->fn(t);
-        sTimeoutLock = k_interrupt_disable();
-        sAnnounceRemaining -= dt;
+        K_TRACE_TIMEOUT_EXPIRE_END(t);
+        key = k_spin_lock(&tc->lock);
+        tc->announce_remaining -= dt;
     }
 
     if (t != NULL) {
-		t->dticks -= sAnnounceRemaining;
+		t->dticks -= tc->announce_remaining;
 	}
 
-    sCurrTick += sAnnounceRemaining;
-	sAnnounceRemaining = 0;
+    tc->curr_tick += tc->announce_remaining;
+	tc->announce_remaining = 0;
 
-    sys_clock_set_timeout(next_timeout(), false);
+    sys_clock_set_timeout(next_timeout(tc), false);
 
-    k_interrupt_enable(sTimeoutLock);
+    k_spin_unlock(&tc->lock, key);
+    K_LOAD_EXIT(load);
 }
 
@@ -11,6 +11,10 @@
 
 #ifdef K_CONFIG_TIMER
 
+#ifdef K_CONFIG_KERNEL_MEM_SLAB
+K_MEM_SLAB_DEFINE(sTimerSlab, sizeof(k_timer_t), K_CONFIG_TIMER_DYNAMIC_NUM, sizeof(void *));
+#endif
+
 static void timer_expiration_handler(struct _timeout *t) {
     struct k_timer *timer = CONTAINER_OF(t, struct k_timer, timeout);
     /*
@@ -33,7 +37,13 @@ static void timer_expiration_handler(struct _timeout *t) {
 k_timer_t *k_timer_create(k_timer_expiry_t expiry_fn, void *user_data) {
     k_timer_t *timer = NULL;
 
+#ifdef K_CONFIG_KERNEL_MEM_SLAB
+    if (k_mem_slab_alloc(&sTimerSlab, (void **)&timer) != 0) {
+        timer = NULL;
+    }
+#else
     timer = (k_timer_t *)K_MALLOC(sizeof(k_timer_t));
+#endif
     if (timer) {
         timer->expiry_fn = expiry_fn;
         timer->user_data = user_data;
@@ -63,4 +73,20 @@ void k_timer_stop(k_timer_t *timer) {
     return;
 }
 
+/**
+ * @brief Stop and release a timer obtained from k_timer_create().
+ *
+ * Must not be used on statically defined or k_timer_init() timers.
+ *
+ * @param timer Address of the timer.
+ */
+void k_timer_delete(k_timer_t *timer) {
+    (void)k_timeout_abort(&timer->timeout);
+#ifdef K_CONFIG_KERNEL_MEM_SLAB
+    k_mem_slab_free(&sTimerSlab, timer);
+#else
+    K_FREE(timer);
+#endif
+}
+
 #endif // K_CONFIG_TIMER
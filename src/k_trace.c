@@ -0,0 +1,79 @@
+/*
+ * @Date: 2026-10-20 19:25:40
+ * @FilePath: \Openy_Framework\src\k_trace.c
+ * @Description: Binary event tracing of timeouts, work, msgq and HSM
+ *
+ * Writers claim a slot with one atomic increment of the head and fill it
+ * in place, no lock and no interrupt masking, so the hooks are usable in
+ * any context and on any core. A writer preempted between the claim and
+ * the store may leave its slot stale for a moment, dump with tracing
+ * disabled to get a consistent buffer.
+ */
+#include "k_kernel.h"
+
+#ifdef K_CONFIG_TRACE
+
+#if (K_CONFIG_TRACE_EVENTS & (K_CONFIG_TRACE_EVENTS - 1)) != 0
+#error "K_CONFIG_TRACE_EVENTS must be a power of 2"
+#endif
+
+static struct k_trace_event sEvents[K_CONFIG_TRACE_EVENTS];
+static atomic_t sHead;
+static atomic_t sEnabled = 1;
+
+void z_trace_event(uint8_t id, const void *obj, uint32_t arg) {
+    struct k_trace_event *ev;
+
+    if (atomic_get(&sEnabled) == 0) {
+        return;
+    }
+
+    ev = &sEvents[(uint32_t)atomic_inc(&sHead) & (K_CONFIG_TRACE_EVENTS - 1U)];
+    ev->timestamp = k_cycle_get_32();
+    ev->id = id;
+    ev->cpu = (uint8_t)k_cpu_id();
+    ev->reserved = 0;
+    ev->obj = (uint32_t)(uintptr_t)obj;
+    ev->arg = arg;
+}
+
+/**
+ * @brief Start or stop recording, the buffer is kept.
+ */
+void k_trace_enable(bool enable) { (void)atomic_set(&sEnabled, enable ? 1 : 0); }
+
+/**
+ * @brief Drop every record.
+ */
+void k_trace_clear(void) { (void)atomic_clear(&sHead); }
+
+/**
+ * @brief Stream the header and the records, oldest first, through @a write.
+ *
+ * Recording is paused for the dump and resumed afterwards if it was on.
+ *
+ * @param write Called with consecutive chunks of the dump, e.g. a UART or
+ *        file writer.
+ * @param user_data Passed back to @a write.
+ */
+void k_trace_dump(k_trace_write_t write, void *user_data) {
+    struct k_trace_header hdr;
+    atomic_t was_enabled = atomic_set(&sEnabled, 0);
+    uint32_t head = (uint32_t)atomic_get(&sHead);
+    uint32_t count = MIN(head, (uint32_t)K_CONFIG_TRACE_EVENTS);
+
+    (void)memcpy(hdr.magic, K_TRACE_MAGIC, sizeof(hdr.magic));
+    hdr.version = K_TRACE_VERSION;
+    hdr.record_size = sizeof(struct k_trace_event);
+    hdr.cycles_per_sec = k_cycle_hz();
+    hdr.count = count;
+    write(&hdr, sizeof(hdr), user_data);
+
+    for (uint32_t i = head - count; i != head; i++) {
+        write(&sEvents[i & (K_CONFIG_TRACE_EVENTS - 1U)], sizeof(struct k_trace_event), user_data);
+    }
+
+    (void)atomic_set(&sEnabled, was_enabled);
+}
+
+#endif // K_CONFIG_TRACE
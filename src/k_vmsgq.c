@@ -0,0 +1,243 @@
+/*
+ * @Date: 2026-10-19 22:31:47
+ * @FilePath: \Openy_Framework\src\k_vmsgq.c
+ * @Description: Variable-length message queue on top of ring_buf
+ *
+ * Records are [header][payload padded to 4 bytes] and are always
+ * contiguous in the buffer: when a record does not fit before the end of
+ * the buffer, the tail is filled with a padding record that the consumer
+ * skips. This is what allows zero-copy claim/commit on both sides.
+ */
+#include "k_kernel.h"
+
+#if defined(K_CONFIG_VMSGQ) && defined(K_CONFIG_RINGBUFFER)
+
+#define VMSGQ_TYPE_PAD 0xFFFFU
+
+/* Unlike struct ring_element the length is in bytes and 16 bits wide, so
+ * messages are not limited to 1020 bytes.
+ */
+struct vmsgq_hdr {
+    uint32_t type : 16;
+    uint32_t length : 16;
+};
+
+#define VMSGQ_HDR_SIZE      sizeof(struct vmsgq_hdr)
+#define VMSGQ_PAD4(size)    (DIV_ROUND_UP(size, 4U) * 4U)
+
+void k_vmsgq_init(k_vmsgq_t *msgq, uint32_t *buffer, uint32_t size32) {
+    ring_buf_item_init(&msgq->rb, size32, buffer);
+    msgq->put_hdr = NULL;
+    msgq->put_size = 0;
+    msgq->get_size = 0;
+}
+
+/**
+ * @brief Claim contiguous room for a message of up to @a size bytes.
+ *
+ * The payload is written in place through @a data and published with
+ * k_vmsgq_put_commit(). Only one claim may be outstanding, producers
+ * using claim/commit must not run concurrently with other producers.
+ *
+ * @retval 0 on success
+ * @retval -EMSGSIZE @a size exceeds K_VMSGQ_MSG_SIZE_MAX or the buffer
+ * @retval -ENOMEM not enough contiguous free space right now
+ */
+int k_vmsgq_put_claim(k_vmsgq_t *msgq, void **data, uint32_t size) {
+    struct ring_buf *rb = &msgq->rb;
+    uint8_t *dst;
+    uint32_t need, got, space;
+
+    if (size > K_VMSGQ_MSG_SIZE_MAX || VMSGQ_HDR_SIZE + VMSGQ_PAD4(size) > rb->size) {
+        return -EMSGSIZE;
+    }
+    need = VMSGQ_HDR_SIZE + VMSGQ_PAD4(size);
+
+    space = ring_buf_space_get(rb);
+    got = ring_buf_put_claim(rb, &dst, need);
+    if (got < need) {
+        (void)ring_buf_put_finish(rb, 0);
+
+        /* short because of the wrap: pad to the end and start over from
+         * the beginning, but only if the record then fits
+         */
+        if (space < got + need) {
+            return -ENOMEM;
+        }
+
+        struct vmsgq_hdr *pad = (struct vmsgq_hdr *)dst;
+        pad->type = VMSGQ_TYPE_PAD;
+        pad->length = got - VMSGQ_HDR_SIZE;
+        (void)ring_buf_put_claim(rb, &dst, got);
+        (void)ring_buf_put_finish(rb, got);
+
+        got = ring_buf_put_claim(rb, &dst, need);
+        __ASSERT_NO_MSG(got == need);
+    }
+
+    msgq->put_hdr = dst;
+    msgq->put_size = size;
+    *data = dst + VMSGQ_HDR_SIZE;
+
+    return 0;
+}
+
+/**
+ * @brief Publish a message written into the area from k_vmsgq_put_claim().
+ *
+ * @param msgq Address of the message queue.
+ * @param type Message type (application specific, 0xFFFF is reserved).
+ * @param size Actual payload size, at most the claimed size.
+ *
+ * @retval 0 on success
+ * @retval -EINVAL no claim outstanding or @a size too big
+ */
+int k_vmsgq_put_commit(k_vmsgq_t *msgq, uint16_t type, uint32_t size) {
+    struct vmsgq_hdr *hdr = (struct vmsgq_hdr *)msgq->put_hdr;
+
+    if (hdr == NULL || size > msgq->put_size || type == VMSGQ_TYPE_PAD) {
+        return -EINVAL;
+    }
+
+    hdr->type = type;
+    hdr->length = size;
+    msgq->put_hdr = NULL;
+
+    /* surplus claimed bytes go back to the free space */
+    return ring_buf_put_finish(&msgq->rb, VMSGQ_HDR_SIZE + VMSGQ_PAD4(size));
+}
+
+/**
+ * @brief Claim the oldest message for in-place reading.
+ *
+ * The message stays in the queue until k_vmsgq_get_finish().
+ *
+ * @retval 0 on success
+ * @retval -EINVAL the queue is empty
+ */
+int k_vmsgq_get_claim(k_vmsgq_t *msgq, uint16_t *type, void **data, uint32_t *size) {
+    struct ring_buf *rb = &msgq->rb;
+    struct vmsgq_hdr *hdr;
+    uint8_t *src;
+    uint32_t got;
+
+    for (;;) {
+        if (ring_buf_is_empty(rb)) {
+            return -EINVAL;
+        }
+
+        got = ring_buf_get_claim(rb, &src, VMSGQ_HDR_SIZE);
+        __ASSERT_NO_MSG(got == VMSGQ_HDR_SIZE);
+        hdr = (struct vmsgq_hdr *)src;
+
+        if (hdr->type != VMSGQ_TYPE_PAD) {
+            break;
+        }
+        (void)ring_buf_get_claim(rb, &src, hdr->length);
+        (void)ring_buf_get_finish(rb, VMSGQ_HDR_SIZE + hdr->length);
+    }
+
+    got = ring_buf_get_claim(rb, &src, VMSGQ_PAD4(hdr->length));
+    __ASSERT_NO_MSG(got == VMSGQ_PAD4(hdr->length));
+    ARG_UNUSED(got);
+
+    msgq->get_size = VMSGQ_HDR_SIZE + VMSGQ_PAD4(hdr->length);
+    *type = hdr->type;
+    *size = hdr->length;
+    *data = src;
+
+    return 0;
+}
+
+/**
+ * @brief Release the message claimed with k_vmsgq_get_claim().
+ */
+int k_vmsgq_get_finish(k_vmsgq_t *msgq) {
+    int err = ring_buf_get_finish(&msgq->rb, msgq->get_size);
+
+    msgq->get_size = 0;
+    return err;
+}
+
+/**
+ * @brief Copy a message into the queue.
+ *
+ * Runs with interrupts masked, so it may be used by several producers as
+ * long as none of them uses claim/commit at the same time.
+ *
+ * @retval 0 on success
+ * @retval -EMSGSIZE @a size exceeds K_VMSGQ_MSG_SIZE_MAX or the buffer
+ * @retval -ENOMEM not enough free space
+ */
+int k_vmsgq_put(k_vmsgq_t *msgq, uint16_t type, const void *data, uint32_t size) {
+    void *dst;
+    int err;
+
+    atomic_t key = k_interrupt_disable();
+    err = k_vmsgq_put_claim(msgq, &dst, size);
+    if (err == 0) {
+        (void)K_MEMCPY(dst, data, size);
+        err = k_vmsgq_put_commit(msgq, type, size);
+    }
+    k_interrupt_enable(key);
+
+    return err;
+}
+
+/**
+ * @brief Copy the oldest message out of the queue.
+ *
+ * @param msgq Address of the message queue.
+ * @param type Area to store the message type.
+ * @param data Area to store the payload. Can be NULL to discard it.
+ * @param size In: size of @a data. Out: payload size.
+ *
+ * @retval 0 on success
+ * @retval -EINVAL the queue is empty
+ * @retval -EMSGSIZE @a data is too small, @a size now holds the size needed
+ */
+int k_vmsgq_get(k_vmsgq_t *msgq, uint16_t *type, void *data, uint32_t *size) {
+    void *src;
+    uint32_t len;
+    int err;
+
+    atomic_t key = k_interrupt_disable();
+    err = k_vmsgq_get_claim(msgq, type, &src, &len);
+    if (err == 0) {
+        if (data != NULL && len > *size) {
+            /* leave the message queued */
+            (void)ring_buf_get_finish(&msgq->rb, 0);
+            msgq->get_size = 0;
+            err = -EMSGSIZE;
+        } else {
+            if (data != NULL) {
+                (void)K_MEMCPY(data, src, len);
+            }
+            err = k_vmsgq_get_finish(msgq);
+        }
+        *size = len;
+    }
+    k_interrupt_enable(key);
+
+    return err;
+}
+
+bool k_vmsgq_is_empty(k_vmsgq_t *msgq) {
+    struct ring_buf *rb = &msgq->rb;
+    uint8_t *src;
+    bool empty = true;
+
+    /* a trailing padding record alone does not count as a message */
+    atomic_t key = k_interrupt_disable();
+    if (!ring_buf_is_empty(rb)) {
+        (void)ring_buf_get_claim(rb, &src, VMSGQ_HDR_SIZE);
+        empty = ((struct vmsgq_hdr *)src)->type == VMSGQ_TYPE_PAD &&
+                ring_buf_size_get(rb) == VMSGQ_HDR_SIZE + ((struct vmsgq_hdr *)src)->length;
+        (void)ring_buf_get_finish(rb, 0);
+    }
+    k_interrupt_enable(key);
+
+    return empty;
+}
+
+#endif // K_CONFIG_VMSGQ
@@ -8,7 +8,26 @@
 
 #ifdef K_CONFIG_WORKQ
 
-static struct k_queue sWork_q;
+/* Work queue of one core. The inbox is a lock-free stack other cores and
+ * allocation-free submitters push onto, the owner takes it whole and
+ * replays it oldest first from local.
+ */
+struct work_cpu {
+    struct k_queue q;
+    atomic_ptr_t inbox;
+    k_work_user_t *local;
+    void (*notify)(void *user_data);
+    void *notify_data;
+    struct k_spinlock lock;
+};
+
+static struct work_cpu sWorkCpu[Z_NUM_CPUS];
+
+#ifdef K_CONFIG_SMP
+#define WORK_DWORK_CPU(dwork) ((int)(dwork)->cpu)
+#else
+#define WORK_DWORK_CPU(dwork) 0
+#endif
 
 /* Timeout handler for delayable work.
  *
@@ -18,29 +37,147 @@ static struct k_queue sWork_q;
  */
 static void work_timeout(struct _timeout *to) {
     struct k_work_delayable *dwork = CONTAINER_OF(to, struct k_work_delayable, timeout);
-    (void)k_work_user_submit(&dwork->work);
+    (void)k_work_user_submit_to_cpu(WORK_DWORK_CPU(dwork), &dwork->work);
 }
 
-int k_work_user_submit(k_work_user_t *work) {
+static void work_inbox_push(struct work_cpu *wc, k_work_user_t *work) {
+    void *head;
+
+    /* push only, a popped head can't come back under us, no ABA */
+    do {
+        head = atomic_ptr_get(&wc->inbox);
+        work->next = head;
+    } while (!atomic_ptr_cas(&wc->inbox, head, work));
+}
+
+/* Next inbox item of the calling core, in submission order */
+static k_work_user_t *work_inbox_get(struct work_cpu *wc) {
+    k_work_user_t *work = wc->local;
+
+    if (work == NULL && atomic_ptr_get(&wc->inbox) != NULL) {
+        k_work_user_t *list = atomic_ptr_clear(&wc->inbox);
+
+        while (list != NULL) {
+            k_work_user_t *next = list->next;
+
+            list->next = work;
+            work = list;
+            list = next;
+        }
+    }
+    if (work != NULL) {
+        wc->local = work->next;
+    }
+    return work;
+}
+
+static int work_submit(int cpu, k_work_user_t *work, bool alloc) {
+    struct work_cpu *wc;
+    void (*notify)(void *user_data);
+    void *notify_data;
+    k_spinlock_key_t key;
     int ret = -EINVAL;
 
+    if (cpu < 0 || cpu >= Z_NUM_CPUS) {
+        return -EINVAL;
+    }
+    wc = &sWorkCpu[cpu];
+
     if (!atomic_test_and_set_bit(&work->flags, 0)) {
-        ret = k_queue_alloc_append(&sWork_q, work);
+        if (!alloc || cpu != k_cpu_id()) {
+            work_inbox_push(wc, work);
+            ret = 0;
+        } else {
+            ret = k_queue_alloc_append(&wc->q, work);
+        }
 
         /* Couldn't insert into the queue. Clear the pending bit
          * so the work item can be submitted again
          */
         if (ret != 0) {
             atomic_clear_bit(&work->flags, 0);
+        } else {
+            K_TRACE_WORK_SUBMIT(work, cpu);
+            /* the pair is set together by its core, read it the same way */
+            key = k_spin_lock(&wc->lock);
+            notify = wc->notify;
+            notify_data = wc->notify_data;
+            k_spin_unlock(&wc->lock, key);
+            if (notify != NULL) {
+                notify(notify_data);
+            }
         }
     }
 
     return ret;
 }
 
+/**
+ * @brief Submit a work item to the calling core's queue.
+ *
+ * @funcprops \isr_ok
+ *
+ * @retval 0 on success
+ * @retval -EINVAL already pending
+ * @retval -ENOMEM no queue node available
+ */
+int k_work_user_submit(k_work_user_t *work) { return k_work_user_submit_to_cpu(k_cpu_id(), work); }
+
+/**
+ * @brief Submit a work item to the queue of @a cpu.
+ *
+ * Another core's queue is reached through its inbox, which never fails
+ * and takes no lock. The notify callback of @a cpu is called from here.
+ *
+ * @funcprops \isr_ok
+ *
+ * @retval 0 on success
+ * @retval -EINVAL already pending, or no such core
+ * @retval -ENOMEM no queue node available
+ */
+int k_work_user_submit_to_cpu(int cpu, k_work_user_t *work) {
+    return work_submit(cpu, work, true);
+}
+
+/**
+ * @brief Submit a work item to @a cpu without allocating a queue node.
+ *
+ * The item is linked through its own next field into the inbox of @a cpu,
+ * so this cannot fail for lack of memory. On the calling core such items
+ * run ahead of items queued by k_work_user_submit().
+ *
+ * @funcprops \isr_ok
+ *
+ * @retval 0 on success
+ * @retval -EINVAL already pending, or no such core
+ */
+int k_work_user_submit_noalloc_to_cpu(int cpu, k_work_user_t *work) {
+    return work_submit(cpu, work, false);
+}
+
 int k_work_schedule(k_work_delayable_t *dwork, k_timeout_t delay) {
+    return k_work_schedule_for_cpu(k_cpu_id(), dwork, delay);
+}
+
+/**
+ * @brief Submit a work item to @a cpu after a delay.
+ *
+ * The delay runs on the calling core's timeout list, the expiry hands the
+ * item over to @a cpu. Rescheduling a pending item with another @a cpu
+ * migrates it.
+ *
+ * @retval 0 on success
+ * @retval -EINVAL no such core, or already pending when @a delay is K_NO_WAIT
+ */
+int k_work_schedule_for_cpu(int cpu, k_work_delayable_t *dwork, k_timeout_t delay) {
+    if (cpu < 0 || cpu >= Z_NUM_CPUS) {
+        return -EINVAL;
+    }
+#ifdef K_CONFIG_SMP
+    dwork->cpu = (uint8_t)cpu;
+#endif
     if (K_TIMEOUT_EQ(delay, K_NO_WAIT)) {
-        return k_work_user_submit(&dwork->work);
+        return k_work_user_submit_to_cpu(cpu, &dwork->work);
     }
     (void)k_timeout_abort(&dwork->timeout);
     k_timeout_add(&dwork->timeout, work_timeout, delay);
@@ -48,11 +185,21 @@ int k_work_schedule(k_work_delayable_t *dwork, k_timeout_t delay) {
     return 0;
 }
 
+/**
+ * @brief Run one work item of the calling core.
+ *
+ * @retval 0 an item was run
+ * @retval -EINVAL nothing to run
+ */
 int k_work_user_wait(void) {
-    k_work_user_t *work;
+    struct work_cpu *wc = &sWorkCpu[k_cpu_id()];
+    k_work_user_t *work = NULL;
     k_work_user_handler_t handler;
 
-    work = k_queue_get(&sWork_q);
+    work = work_inbox_get(wc);
+    if (work == NULL) {
+        work = k_queue_get(&wc->q);
+    }
     if (work == NULL) {
         return -EINVAL;
     }
@@ -62,11 +209,32 @@ int k_work_user_wait(void) {
 
     /* Reset pending state so it can be resubmitted by handler */
     if (atomic_test_and_clear_bit(&work->flags, 0)) {
+        K_TRACE_WORK_START(work);
+        K_LOAD_ENTER(load, K_LOAD_WORK);
         handler(work);
+        K_LOAD_EXIT(load);
+        K_TRACE_WORK_END(work);
         return 0;
     }
     return -EINVAL;
 }
 
+/**
+ * @brief Install a callback invoked after every successful submit.
+ *
+ * The callback belongs to the calling core's queue. It runs in the
+ * submitter's context, possibly an ISR or another core.
+ *
+ * @param notify Callback, or NULL to remove it.
+ * @param user_data Passed back to @a notify.
+ */
+void k_work_user_set_notify(void (*notify)(void *user_data), void *user_data) {
+    struct work_cpu *wc = &sWorkCpu[k_cpu_id()];
+    k_spinlock_key_t key = k_spin_lock(&wc->lock);
+
+    wc->notify = notify;
+    wc->notify_data = user_data;
+    k_spin_unlock(&wc->lock, key);
+}
 
 #endif // K_CONFIG_WORKQ
@@ -0,0 +1,60 @@
+/*
+ * @Date: 2026-10-21 09:30:12
+ * @FilePath: \Openy_Framework\tests\host\k_host.h
+ * @Description: Host port for the unit tests and benchmarks
+ *
+ * Each pthread plays a core (the tests build with K_CONFIG_SMP), interrupt
+ * masking is a per-thread flag and the cycle counter is CLOCK_MONOTONIC in
+ * nanoseconds.
+ */
+#ifndef __K_HOST_H
+#define __K_HOST_H
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "k_kernel.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* core number k_cpu_id() returns in the calling thread */
+void k_host_cpu_set(int id);
+
+static inline uint64_t k_host_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* "bench" on the command line: run the benchmarks after the tests */
+static inline bool k_host_bench(int argc, char **argv) {
+    return argc > 1 && strcmp(argv[1], "bench") == 0;
+}
+
+/* start n threads running fn(i), return when all are done */
+void k_host_run_threads(int n, void *(*fn)(void *));
+
+#ifdef __cplusplus
+}
+#endif
+
+#define K_HOST_ASSERT(cond, ...)                                                                   \
+    do {                                                                                           \
+        if (!(cond)) {                                                                             \
+            fprintf(stderr, "%s:%d: %s: ", __FILE__, __LINE__, #cond);                             \
+            fprintf(stderr, __VA_ARGS__);                                                          \
+            fputc('\n', stderr);                                                                   \
+            exit(1);                                                                               \
+        }                                                                                          \
+    } while (0)
+
+#define K_HOST_PASS() printf("%s: pass\n", __FILE__)
+
+#endif // __K_HOST_H
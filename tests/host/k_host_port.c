@@ -0,0 +1,83 @@
+/*
+ * @Date: 2026-10-21 09:30:12
+ * @FilePath: \Openy_Framework\tests\host\k_host_port.c
+ * @Description: Host port for the unit tests and benchmarks
+ */
+#include <stdarg.h>
+
+#include "k_host.h"
+
+#ifdef K_CONFIG_IRQ_PROFILE
+/* this file implements the primitives the profiler wraps */
+#undef k_interrupt_disable
+#undef k_interrupt_enable
+#endif
+
+static __thread atomic_t sMasked;
+static __thread int sCpu;
+
+atomic_t k_interrupt_disable(void) {
+    atomic_t key = sMasked;
+
+    sMasked = 1;
+    return key;
+}
+
+void k_interrupt_enable(atomic_t key) { sMasked = key; }
+
+void k_cpu_atomic_idle(atomic_t key) { k_interrupt_enable(key); }
+
+int k_cpu_id(void) { return sCpu; }
+
+void k_host_cpu_set(int id) { sCpu = id; }
+
+void k_print(int level, const char *fmt, ...) {
+    const char *level_str[] = {"[INFO] ", "[DEBUG] ", "[ERROR] "};
+    va_list args;
+
+    printf("%s", level_str[level]);
+    va_start(args, fmt);
+    vprintf(fmt, args);
+    va_end(args);
+    printf("\n");
+}
+
+uint32_t k_cycle_get_32(void) { return (uint32_t)k_host_ns(); }
+
+uint32_t k_cycle_hz(void) { return 1000000000U; }
+
+void k_msleep(int32_t ms) {
+    struct timespec ts = {ms / 1000, (long)(ms % 1000) * 1000000L};
+
+    nanosleep(&ts, NULL);
+}
+
+void sys_clock_set_timeout(int32_t ticks, bool idle) {
+    ARG_UNUSED(ticks);
+    ARG_UNUSED(idle);
+}
+
+uint32_t sys_clock_elapsed(void) { return 0; }
+
+void sys_clock_isr(void) {}
+
+static void *(*sThreadFn)(void *);
+
+static void *host_thread(void *arg) {
+    k_host_cpu_set((int)(intptr_t)arg % Z_NUM_CPUS);
+    return sThreadFn(arg);
+}
+
+void k_host_run_threads(int n, void *(*fn)(void *)) {
+    pthread_t threads[16];
+
+    K_HOST_ASSERT(n <= 16, "%d threads", n);
+    sThreadFn = fn;
+    for (int i = 0; i < n; i++) {
+        K_HOST_ASSERT(pthread_create(&threads[i], NULL, host_thread, (void *)(intptr_t)i) == 0,
+                      "pthread_create");
+    }
+    for (int i = 0; i < n; i++) {
+        pthread_join(threads[i], NULL);
+    }
+}
@@ -0,0 +1,160 @@
+/*
+ * @Date: 2026-10-21 09:41:27
+ * @FilePath: \Openy_Framework\tests\host\test_atomic.c
+ * @Description: port/k_atomic.c return values, bit arrays, and concurrent
+ * read-modify-write from several threads; "bench" adds ops/sec figures
+ */
+#include "k_host.h"
+
+#define THREADS 4
+#define LOOPS   200000
+
+static atomic_t sCounter;
+static atomic_t sBits;
+static atomic_t sLock;
+static long sGuarded;
+
+static void test_values(void) {
+    atomic_t v = 10;
+    atomic_t bits[2] = {0, 0};
+    int x, y;
+    atomic_ptr_t p = &x;
+
+    K_HOST_ASSERT(atomic_add(&v, 5) == 10 && v == 15, "add");
+    K_HOST_ASSERT(atomic_sub(&v, 20) == 15 && v == -5, "sub");
+    K_HOST_ASSERT(atomic_inc(&v) == -5 && atomic_dec(&v) == -4 && v == -5, "inc/dec");
+    v = 0x0F;
+    K_HOST_ASSERT(atomic_or(&v, 0xF0) == 0x0F && v == 0xFF, "or");
+    K_HOST_ASSERT(atomic_and(&v, 0x3C) == 0xFF && v == 0x3C, "and");
+    K_HOST_ASSERT(atomic_xor(&v, 0xFF) == 0x3C && v == 0xC3, "xor");
+    K_HOST_ASSERT(atomic_nand(&v, 0x0F) == 0xC3 && v == ~(atomic_t)0x03, "nand");
+    K_HOST_ASSERT(atomic_set(&v, 7) == ~(atomic_t)0x03 && atomic_get(&v) == 7, "set/get");
+    K_HOST_ASSERT(!atomic_cas(&v, 6, 9) && v == 7, "cas mismatch");
+    K_HOST_ASSERT(atomic_cas(&v, 7, 9) && v == 9, "cas match");
+    K_HOST_ASSERT(atomic_clear(&v) == 9 && v == 0, "clear");
+
+    K_HOST_ASSERT(atomic_ptr_get(&p) == &x, "ptr get");
+    K_HOST_ASSERT(!atomic_ptr_cas(&p, &y, NULL) && p == &x, "ptr cas mismatch");
+    K_HOST_ASSERT(atomic_ptr_cas(&p, &x, &y) && p == &y, "ptr cas match");
+    K_HOST_ASSERT(atomic_ptr_set(&p, &x) == &y && atomic_ptr_clear(&p) == &x && p == NULL,
+                  "ptr set/clear");
+
+    /* bit numbers past the first word index into the array */
+    int hi = (int)(sizeof(atomic_t) * 8U) + 3;
+
+    K_HOST_ASSERT(!atomic_test_and_set_bit(bits, hi) && atomic_test_and_set_bit(bits, hi),
+                  "test_and_set_bit");
+    K_HOST_ASSERT(bits[0] == 0 && bits[1] == 0x8, "bit %d in word 1", hi);
+    atomic_set_bit(bits, 0);
+    atomic_set_bit_to(bits, 1, true);
+    K_HOST_ASSERT(bits[0] == 0x3 && atomic_test_bit(bits, 1), "set_bit");
+    atomic_set_bit_to(bits, 1, false);
+    atomic_clear_bit(bits, 0);
+    K_HOST_ASSERT(bits[0] == 0 && !atomic_test_bit(bits, 0), "clear_bit");
+    K_HOST_ASSERT(atomic_test_and_clear_bit(bits, hi) && !atomic_test_and_clear_bit(bits, hi) &&
+                      bits[1] == 0,
+                  "test_and_clear_bit");
+}
+
+static void *rmw_thread(void *arg) {
+    int id = (int)(intptr_t)arg;
+
+    for (int i = 0; i < LOOPS; i++) {
+        atomic_t old;
+
+        (void)atomic_inc(&sCounter);
+        (void)atomic_add(&sCounter, 3);
+        (void)atomic_sub(&sCounter, 2);
+        do {
+            old = atomic_get(&sCounter);
+        } while (!atomic_cas(&sCounter, old, old + 1));
+        /* each thread flips its own bit, an even number of times */
+        (void)atomic_xor(&sBits, (atomic_t)1 << id);
+    }
+    return NULL;
+}
+
+static void *bit_thread(void *arg) {
+    int id = (int)(intptr_t)arg;
+
+    for (int i = 0; i < LOOPS; i++) {
+        atomic_set_bit(&sBits, id);
+        K_HOST_ASSERT(atomic_test_bit(&sBits, id), "own bit lost");
+        atomic_clear_bit(&sBits, id);
+        K_HOST_ASSERT(!atomic_test_bit(&sBits, id), "own bit stuck");
+    }
+    return NULL;
+}
+
+/* atomic_test_and_set_bit() as a lock, the plain counter it guards must
+ * not lose updates
+ */
+static void *lock_thread(void *arg) {
+    ARG_UNUSED(arg);
+
+    for (int i = 0; i < LOOPS; i++) {
+        while (atomic_test_and_set_bit(&sLock, 0)) {
+        }
+        sGuarded++;
+        atomic_clear_bit(&sLock, 0);
+    }
+    return NULL;
+}
+
+static void test_concurrent(void) {
+    sCounter = 0;
+    sBits = 0;
+    k_host_run_threads(THREADS, rmw_thread);
+    K_HOST_ASSERT(sCounter == (atomic_t)THREADS * LOOPS * 3, "counter %ld", (long)sCounter);
+    K_HOST_ASSERT(sBits == 0, "xor bits %lx", (long)sBits);
+
+    k_host_run_threads(THREADS, bit_thread);
+    K_HOST_ASSERT(sBits == 0, "bits %lx", (long)sBits);
+
+    sGuarded = 0;
+    k_host_run_threads(THREADS, lock_thread);
+    K_HOST_ASSERT(sGuarded == (long)THREADS * LOOPS, "guarded %ld", sGuarded);
+}
+
+static void *inc_thread(void *arg) {
+    ARG_UNUSED(arg);
+    for (int i = 0; i < LOOPS * 5; i++) {
+        (void)atomic_inc(&sCounter);
+    }
+    return NULL;
+}
+
+static void *cas_thread(void *arg) {
+    ARG_UNUSED(arg);
+    for (int i = 0; i < LOOPS * 5; i++) {
+        atomic_t old;
+
+        do {
+            old = atomic_get(&sCounter);
+        } while (!atomic_cas(&sCounter, old, old + 1));
+    }
+    return NULL;
+}
+
+static void bench(const char *name, void *(*fn)(void *), int threads) {
+    uint64_t t0 = k_host_ns();
+
+    sCounter = 0;
+    k_host_run_threads(threads, fn);
+    printf("%-18s %d thread(s): %7.1f Mops/s\n", name, threads,
+           (double)sCounter * 1e3 / (double)(k_host_ns() - t0));
+}
+
+int main(int argc, char **argv) {
+    test_values();
+    test_concurrent();
+    K_HOST_PASS();
+
+    if (k_host_bench(argc, argv)) {
+        bench("atomic_inc", inc_thread, 1);
+        bench("atomic_inc", inc_thread, THREADS);
+        bench("atomic_cas loop", cas_thread, 1);
+        bench("atomic_cas loop", cas_thread, THREADS);
+    }
+    return 0;
+}
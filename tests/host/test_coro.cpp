@@ -0,0 +1,130 @@
+/*
+ * @Date: 2026-10-21 17:25:40
+ * @FilePath: \Openy_Framework\tests\host\test_coro.cpp
+ * @Description: k_coro.hpp sleep and msgq wake-ups while the queue node
+ * pool is exhausted, the message handed over is never lost; two cores
+ * feeding each other's queues while sharing the frame pool; built with
+ * K_CONFIG_KERNEL_MEM_SLAB so k_queue nodes come from a fixed slab
+ */
+#include "k_host.h"
+#include "k_coro.hpp"
+
+K_CORO_MSGQ_DEFINE(sQ, uint32_t, 4);
+
+static int sStep;
+static uint32_t sGot[2];
+
+static k::task consumer(void) {
+    sStep = 1;
+    co_await k::sleep(K_MSEC(10));
+    sStep = 2;
+    sGot[0] = co_await sQ.get();
+    sStep = 3;
+    sGot[1] = co_await sQ.get();
+    sStep = 4;
+}
+
+static k::task idle(void) { co_await k::sleep(K_SECONDS(1)); }
+
+static void run_all(void) {
+    while (k_work_user_wait() == 0) {
+    }
+}
+
+static void test_no_node(void) {
+    static k_work_user_t plain = K_WORK_USER_INITIALIZER(NULL);
+    static k_queue_t hog;
+    int hogged = 0;
+    uint32_t v;
+
+    /* drain the node slab the way a burst of submits from ISRs would */
+    k_queue_init(&hog);
+    while (k_queue_alloc_append(&hog, &hog) == 0) {
+        hogged++;
+    }
+    K_HOST_ASSERT(hogged == K_CONFIG_QUEUE_ALLOC_NODES, "%d nodes", hogged);
+    K_HOST_ASSERT(k_work_user_submit(&plain) == -ENOMEM, "plain submit with no node");
+
+    k::task t = consumer();
+    K_HOST_ASSERT(t.valid() && sStep == 1, "started, step %d", sStep);
+    run_all();
+    K_HOST_ASSERT(sStep == 1, "woke before the timeout");
+
+    /* k_timeout_add() waits one tick more than asked */
+    sys_clock_announce((int32_t)k_ms_to_ticks_ceil32(10));
+    run_all();
+    K_HOST_ASSERT(sStep == 1, "woke early");
+    sys_clock_announce(1);
+    run_all();
+    K_HOST_ASSERT(sStep == 2, "sleep not resumed, step %d", sStep);
+
+    /* the first put is taken by the waiter, the second stays queued */
+    v = 42;
+    K_HOST_ASSERT(sQ.put(v) == 0, "put");
+    v = 43;
+    K_HOST_ASSERT(sQ.put(v) == 0, "put");
+    run_all();
+    K_HOST_ASSERT(sStep == 4 && sGot[0] == 42 && sGot[1] == 43, "step %d got %u %u", sStep,
+                  sGot[0], sGot[1]);
+
+    while (k_queue_get(&hog) != NULL) {
+    }
+}
+
+#define ROUNDS 20000U
+
+static k::msgq<uint32_t, 4> sCoreQ[2];
+static uint32_t sDone[2];
+static bool sWaiting[2];
+
+/* one coroutine per round, so frames keep moving through the shared pool;
+ * it is started on core @a cpu and must resume there with the next value
+ */
+static k::task round_consumer(int cpu) {
+    uint32_t v = co_await sCoreQ[cpu].get();
+
+    K_HOST_ASSERT(k_cpu_id() == cpu, "core %d coroutine resumed on core %d", cpu, k_cpu_id());
+    K_HOST_ASSERT(v == sDone[cpu], "core %d got %u, expected %u", cpu, v, sDone[cpu]);
+    sDone[cpu]++;
+    sWaiting[cpu] = false;
+}
+
+static k::task nop(void) { co_return; }
+
+static void *core_thread(void *arg) {
+    int cpu = (int)(intptr_t)arg;
+    uint32_t sent = 0;
+
+    while (sDone[cpu] < ROUNDS || sent < ROUNDS) {
+        if (!sWaiting[cpu] && sDone[cpu] < ROUNDS) {
+            sWaiting[cpu] = true;
+            K_HOST_ASSERT(round_consumer(cpu).valid(), "core %d: no frame", cpu);
+        }
+        (void)nop();
+        if (sent < ROUNDS && sCoreQ[cpu ^ 1].put(sent) == 0) {
+            sent++;
+        }
+        if (k_work_user_wait() != 0) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void test_cores(void) {
+    k_host_run_threads(2, core_thread);
+    K_HOST_ASSERT(sDone[0] == ROUNDS && sDone[1] == ROUNDS, "rounds %u %u", sDone[0], sDone[1]);
+}
+
+int main(void) {
+    test_no_node();
+    test_cores();
+
+    /* frames come from the pool only, one per suspended coroutine */
+    for (int i = 0; i < K_CONFIG_CORO_FRAME_COUNT; i++) {
+        K_HOST_ASSERT(idle().valid(), "frame %d", i);
+    }
+    K_HOST_ASSERT(!idle().valid(), "frame pool exhausted");
+    K_HOST_PASS();
+    return 0;
+}
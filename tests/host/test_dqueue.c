@@ -0,0 +1,105 @@
+/*
+ * @Date: 2026-10-21 14:48:02
+ * @FilePath: \Openy_Framework\tests\host\test_dqueue.c
+ * @Description: k_dqueue order and O(1) remove, and a consumer racing a
+ * canceller on another core: every item is got or removed exactly once
+ */
+#include "k_host.h"
+
+#define ITEMS 64
+#define ROUNDS 5000
+
+struct item {
+    sys_dnode_t node;
+    int value;
+    atomic_t taken;
+};
+
+static struct item sItems[ITEMS];
+static k_dqueue_t sQueue = K_DQUEUE_INITIALIZER(sQueue);
+static atomic_t sRound;
+static atomic_t sRemaining;
+
+static void test_order(void) {
+    struct item *it;
+
+    for (int i = 0; i < 5; i++) {
+        sItems[i].value = i;
+        k_dqueue_append(&sQueue, &sItems[i]);
+    }
+    K_HOST_ASSERT(k_dqueue_remove(&sQueue, &sItems[2]), "remove");
+    K_HOST_ASSERT(!k_dqueue_remove(&sQueue, &sItems[2]), "second remove");
+    k_dqueue_insert(&sQueue, &sItems[4], &sItems[2]);
+    K_HOST_ASSERT(k_dqueue_peek_tail(&sQueue) == &sItems[2], "insert after tail");
+    (void)k_dqueue_remove(&sQueue, &sItems[2]);
+    k_dqueue_prepend(&sQueue, &sItems[2]);
+
+    static const int expect[] = {2, 0, 1, 3, 4};
+
+    for (size_t i = 0; i < ARRAY_SIZE(expect); i++) {
+        it = k_dqueue_get(&sQueue);
+        K_HOST_ASSERT(it != NULL && it->value == expect[i], "get #%zu", i);
+    }
+    K_HOST_ASSERT(k_dqueue_get(&sQueue) == NULL, "empty");
+    /* an item the consumer already got cannot be removed */
+    K_HOST_ASSERT(!k_dqueue_remove(&sQueue, &sItems[0]), "remove after get");
+}
+
+static void item_claim(struct item *it) {
+    K_HOST_ASSERT(atomic_cas(&it->taken, 0, 1), "item %d taken twice", it->value);
+    (void)atomic_dec(&sRemaining);
+}
+
+/* thread 0 fills the queue each round and gets, thread 1 cancels from the
+ * other end; the round ends when all items are accounted for
+ */
+static void *race_thread(void *arg) {
+    int id = (int)(intptr_t)arg;
+
+    for (atomic_t round = 1; round <= ROUNDS; round++) {
+        if (id == 0) {
+            while (atomic_get(&sRemaining) != 0) {
+                sched_yield();
+            }
+            for (int i = 0; i < ITEMS; i++) {
+                sItems[i].taken = 0;
+                k_dqueue_append(&sQueue, &sItems[i]);
+            }
+            (void)atomic_set(&sRemaining, ITEMS);
+            (void)atomic_set(&sRound, round);
+            while (atomic_get(&sRemaining) != 0) {
+                struct item *it = k_dqueue_get(&sQueue);
+
+                if (it != NULL) {
+                    item_claim(it);
+                } else {
+                    sched_yield();
+                }
+            }
+        } else {
+            while (atomic_get(&sRound) < round) {
+                sched_yield();
+            }
+            for (int i = ITEMS - 1; i >= 0 && atomic_get(&sRemaining) != 0; i--) {
+                if (k_dqueue_remove(&sQueue, &sItems[i])) {
+                    item_claim(&sItems[i]);
+                }
+            }
+            while (atomic_get(&sRemaining) != 0) {
+                sched_yield();
+            }
+        }
+    }
+    return NULL;
+}
+
+int main(void) {
+    test_order();
+    for (int i = 0; i < ITEMS; i++) {
+        sItems[i].value = i;
+    }
+    k_host_run_threads(2, race_thread);
+    K_HOST_ASSERT(k_dqueue_get(&sQueue) == NULL, "items left");
+    K_HOST_PASS();
+    return 0;
+}
@@ -0,0 +1,232 @@
+/*
+ * @Date: 2026-10-21 11:40:16
+ * @FilePath: \Openy_Framework\tests\host\test_heap.c
+ * @Description: k_heap split, merge with either neighbour, fragmentation
+ * statistics and a randomized alloc/free run with content checks; "bench"
+ * adds per call latency (mean, 99.99th percentile, worst) of a random
+ * workload against glibc malloc
+ */
+#include "k_host.h"
+
+#define HEAP_SIZE 16384
+
+K_HEAP_DEFINE(sHeap, HEAP_SIZE);
+K_HEAP_DEFINE(sBenchHeap, 60000);
+
+static struct k_heap_stats heap_stats(void) {
+    struct k_heap_stats stats;
+
+    k_heap_stats_get(&sHeap, &stats);
+    return stats;
+}
+
+static void test_errors(void) {
+    static char __attribute__((__aligned__(K_HEAP_ALIGN_SIZE))) mem[64];
+    k_heap_t heap;
+
+    K_HOST_ASSERT(k_heap_init(&heap, mem + 1, sizeof(mem) - 1) == -EINVAL, "misaligned");
+    K_HOST_ASSERT(k_heap_init(&heap, mem, 8) == -EINVAL, "too small");
+    K_HOST_ASSERT(k_heap_init(&heap, mem, sizeof(mem)) == 0, "init");
+    K_HOST_ASSERT(k_heap_alloc(&heap, 0) == NULL, "zero bytes");
+    K_HOST_ASSERT(k_heap_alloc(&heap, sizeof(mem)) == NULL, "larger than the heap");
+}
+
+static void test_split_merge(void) {
+    struct k_heap_stats empty = heap_stats();
+    struct k_heap_stats stats;
+    void *a, *b, *c, *d;
+
+    /* lazily set up on first use: one free block, largest_free is rounded
+     * down to a size class so even this shows a few percent
+     */
+    K_HOST_ASSERT(empty.free_blocks == 1 && empty.allocated_bytes == 0 &&
+                      empty.largest_free > HEAP_SIZE / 2 && empty.fragmentation < 5,
+                  "empty heap: %u blocks, largest %zu", empty.free_blocks, empty.largest_free);
+
+    /* split: the tail of the free block stays free */
+    a = k_heap_alloc(&sHeap, 64);
+    K_HOST_ASSERT(a != NULL && ((uintptr_t)a % K_HEAP_ALIGN_SIZE) == 0U, "alloc %p", a);
+    stats = heap_stats();
+    K_HOST_ASSERT(stats.free_blocks == 1 && stats.allocated_bytes == 64, "split: %u blocks, %zu",
+                  stats.free_blocks, stats.allocated_bytes);
+    k_heap_free(&sHeap, a);
+    stats = heap_stats();
+    K_HOST_ASSERT(stats.free_blocks == 1 && stats.free_bytes == empty.free_bytes, "merge back");
+
+    /* [a][b][c][d][tail]: freeing a and c leaves three holes, b merges
+     * with both neighbours, d with its neighbour and the tail
+     */
+    a = k_heap_alloc(&sHeap, 64);
+    b = k_heap_alloc(&sHeap, 100);
+    c = k_heap_alloc(&sHeap, 64);
+    d = k_heap_alloc(&sHeap, 200);
+    K_HOST_ASSERT(a != NULL && b != NULL && c != NULL && d != NULL, "alloc");
+    K_HOST_ASSERT((char *)a < (char *)b && (char *)b < (char *)c && (char *)c < (char *)d,
+                  "carved in address order");
+    k_heap_free(&sHeap, a);
+    k_heap_free(&sHeap, c);
+    K_HOST_ASSERT(heap_stats().free_blocks == 3, "holes %u", heap_stats().free_blocks);
+    k_heap_free(&sHeap, b);
+    K_HOST_ASSERT(heap_stats().free_blocks == 2, "merge both sides %u", heap_stats().free_blocks);
+    /* the merged hole is reused first fit-wise */
+    b = k_heap_alloc(&sHeap, 200);
+    K_HOST_ASSERT(b == a, "merged hole %p reused as %p", a, b);
+    k_heap_free(&sHeap, b);
+    k_heap_free(&sHeap, d);
+    stats = heap_stats();
+    K_HOST_ASSERT(stats.free_blocks == 1 && stats.free_bytes == empty.free_bytes &&
+                      stats.largest_free == empty.largest_free,
+                  "all merged");
+    K_HOST_ASSERT(stats.max_allocated_bytes >= 64 + 100 + 64 + 200, "max %zu",
+                  stats.max_allocated_bytes);
+    k_heap_runtime_stats_reset_max(&sHeap);
+    K_HOST_ASSERT(heap_stats().max_allocated_bytes == 0, "reset max");
+}
+
+static void test_fragmentation(void) {
+    static void *blocks[HEAP_SIZE / 64];
+    struct k_heap_stats empty = heap_stats();
+    struct k_heap_stats stats;
+    uint32_t fails = heap_stats().alloc_fails;
+    int n = 0;
+
+    while ((blocks[n] = k_heap_alloc(&sHeap, 56)) != NULL) {
+        n++;
+    }
+    K_HOST_ASSERT(n > HEAP_SIZE / 128, "only %d blocks", n);
+    K_HOST_ASSERT(heap_stats().alloc_fails == fails + 1U, "alloc_fails");
+
+    /* free every other block: plenty of free bytes, no block above 56 */
+    for (int i = 0; i < n; i += 2) {
+        k_heap_free(&sHeap, blocks[i]);
+    }
+    stats = heap_stats();
+    K_HOST_ASSERT(stats.free_bytes >= (size_t)(n / 2) * 56U && stats.largest_free < 128,
+                  "free %zu largest %zu", stats.free_bytes, stats.largest_free);
+    K_HOST_ASSERT(stats.fragmentation > 90, "fragmentation %u", stats.fragmentation);
+    K_HOST_ASSERT(k_heap_alloc(&sHeap, 128) == NULL, "128 bytes from 56 byte holes");
+
+    for (int i = 1; i < n; i += 2) {
+        k_heap_free(&sHeap, blocks[i]);
+    }
+    stats = heap_stats();
+    K_HOST_ASSERT(stats.free_blocks == 1 && stats.fragmentation == empty.fragmentation &&
+                      stats.allocated_bytes == 0,
+                  "defragmented: %u blocks, %u%%", stats.free_blocks, stats.fragmentation);
+}
+
+#define SLOTS 64
+
+static void test_random(void) {
+    void *ptr[SLOTS] = {0};
+    size_t size[SLOTS];
+    uint32_t seed = 1;
+    long ok = 0;
+
+    for (int it = 0; it < 200000; it++) {
+        int i;
+
+        seed = seed * 1103515245U + 12345U;
+        i = (int)((seed >> 16) % SLOTS);
+        if (ptr[i] != NULL) {
+            for (size_t k = 0; k < size[i]; k++) {
+                K_HOST_ASSERT(((unsigned char *)ptr[i])[k] == (unsigned char)(i + k),
+                              "slot %d byte %zu overwritten", i, k);
+            }
+            k_heap_free(&sHeap, ptr[i]);
+            ptr[i] = NULL;
+        } else {
+            size[i] = 1U + (seed >> 8) % 600U;
+            ptr[i] = k_heap_alloc(&sHeap, size[i]);
+            if (ptr[i] != NULL) {
+                K_HOST_ASSERT(((uintptr_t)ptr[i] % K_HEAP_ALIGN_SIZE) == 0U, "alignment");
+                for (size_t k = 0; k < size[i]; k++) {
+                    ((unsigned char *)ptr[i])[k] = (unsigned char)(i + k);
+                }
+                ok++;
+            }
+        }
+    }
+    K_HOST_ASSERT(ok > 50000, "only %ld allocations succeeded", ok);
+    for (int i = 0; i < SLOTS; i++) {
+        if (ptr[i] != NULL) {
+            k_heap_free(&sHeap, ptr[i]);
+        }
+    }
+    K_HOST_ASSERT(heap_stats().free_blocks == 1 && heap_stats().allocated_bytes == 0,
+                  "leak after random run");
+}
+
+#define BENCH_OPS 1000000
+
+static uint32_t sLat[BENCH_OPS];
+
+static int lat_cmp(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+static void lat_report(const char *name, uint32_t n) {
+    uint64_t sum = 0;
+
+    for (uint32_t i = 0; i < n; i++) {
+        sum += sLat[i];
+    }
+    qsort(sLat, n, sizeof(sLat[0]), lat_cmp);
+    printf("%-12s mean %5.0f ns, 99.99%% %6u ns, worst %7u ns\n", name, (double)sum / n,
+           sLat[n - n / 10000U - 1U], sLat[n - 1U]);
+}
+
+/* the same random sequence of alloc/free over 64 slots, sizes 8..1024,
+ * each call timed on its own; the worst case includes host preemption,
+ * the 99.99th percentile is the figure to compare
+ */
+static void bench_latency(bool use_heap) {
+    static void *ptr[64];
+    uint32_t seed = 7, n = 0;
+
+    for (uint32_t it = 0; it < BENCH_OPS; it++) {
+        uint32_t i, bytes;
+        uint64_t t0;
+
+        seed = seed * 1103515245U + 12345U;
+        i = (seed >> 16) % 64U;
+        bytes = 8U + (seed >> 4) % 1017U;
+        t0 = k_host_ns();
+        if (ptr[i] != NULL) {
+            if (use_heap) {
+                k_heap_free(&sBenchHeap, ptr[i]);
+            } else {
+                free(ptr[i]);
+            }
+            ptr[i] = NULL;
+        } else {
+            ptr[i] = use_heap ? k_heap_alloc(&sBenchHeap, bytes) : malloc(bytes);
+        }
+        sLat[n++] = (uint32_t)(k_host_ns() - t0);
+    }
+    for (uint32_t i = 0; i < 64U; i++) {
+        if (use_heap) {
+            k_heap_free(&sBenchHeap, ptr[i]);
+        } else {
+            free(ptr[i]);
+        }
+        ptr[i] = NULL;
+    }
+    lat_report(use_heap ? "k_heap" : "glibc malloc", n);
+}
+
+int main(int argc, char **argv) {
+    test_errors();
+    test_split_merge();
+    test_fragmentation();
+    test_random();
+    K_HOST_PASS();
+
+    if (k_host_bench(argc, argv)) {
+        bench_latency(true);
+        bench_latency(false);
+    }
+    return 0;
+}
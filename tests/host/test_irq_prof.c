@@ -0,0 +1,69 @@
+/*
+ * @Date: 2026-10-22 10:20:05
+ * @FilePath: \Openy_Framework\tests\host\test_irq_prof.c
+ * @Description: K_CONFIG_IRQ_PROFILE charges each outermost masked region
+ * to the site that opened it, nested ones to the enclosing region, with
+ * two cores masking at once
+ */
+#include "k_host.h"
+
+#define LOOPS 200000
+
+static volatile uint32_t sSink;
+
+static void spin(int n) {
+    for (int i = 0; i < n; i++) {
+        sSink++;
+    }
+}
+
+static int region_a(void) {
+    atomic_t key = k_interrupt_disable();
+
+    spin(20);
+    k_interrupt_enable(key);
+    return __LINE__ - 4;
+}
+
+static int region_b(void) {
+    atomic_t outer = k_interrupt_disable();
+    atomic_t inner = k_interrupt_disable();
+
+    spin(10);
+    k_interrupt_enable(inner);
+    spin(10);
+    k_interrupt_enable(outer);
+    return __LINE__ - 7;
+}
+
+static int sLine[2];
+
+static void *prof_thread(void *arg) {
+    int id = (int)(intptr_t)arg;
+
+    for (int i = 0; i < LOOPS; i++) {
+        sLine[id] = id == 0 ? region_a() : region_b();
+    }
+    return NULL;
+}
+
+int main(void) {
+    struct k_irq_prof_site site;
+    uint32_t count[2] = {0, 0};
+
+    k_irq_prof_reset();
+    k_host_run_threads(2, prof_thread);
+    for (int i = 0; k_irq_prof_site_get(i, &site) == 0; i++) {
+        K_HOST_ASSERT(strcmp(site.file, __FILE__) == 0, "site %s:%d", site.file, site.line);
+        K_HOST_ASSERT(site.line == sLine[0] || site.line == sLine[1], "line %d", site.line);
+        K_HOST_ASSERT(site.max_cycles > 0U && site.total_cycles >= site.max_cycles, "cycles");
+        count[site.line == sLine[1]] += site.count;
+    }
+    K_HOST_ASSERT(count[0] == LOOPS && count[1] == LOOPS, "counted %u and %u of %d", count[0],
+                  count[1], LOOPS);
+
+    k_irq_prof_reset();
+    K_HOST_ASSERT(k_irq_prof_site_get(0, &site) == -EINVAL, "reset");
+    K_HOST_PASS();
+    return 0;
+}
@@ -0,0 +1,148 @@
+/*
+ * @Date: 2026-10-21 10:31:08
+ * @FilePath: \Openy_Framework\tests\host\test_lifo.c
+ * @Description: k_lifo order and init checks, the tag that keeps a stale
+ * pop from succeeding (ABA), and several threads popping and pushing the
+ * same nodes; "bench" adds push+pop pairs/sec
+ */
+#include "k_host.h"
+
+#define NODES   64
+#define THREADS 4
+#define LOOPS   500000
+
+static struct node {
+    void *link;
+    atomic_t owner;
+} sPool[NODES];
+
+K_LIFO_DEFINE(sLifo, sPool, sizeof(sPool));
+
+static void test_basic(void) {
+    k_lifo_t lifo;
+
+    K_HOST_ASSERT(k_lifo_is_empty(&sLifo) && k_lifo_pop(&sLifo) == NULL, "empty");
+    for (int i = 0; i < 3; i++) {
+        k_lifo_push(&sLifo, &sPool[i]);
+    }
+    for (int i = 2; i >= 0; i--) {
+        K_HOST_ASSERT(k_lifo_pop(&sLifo) == &sPool[i], "pop order %d", i);
+    }
+    K_HOST_ASSERT(k_lifo_is_empty(&sLifo), "empty again");
+
+    K_HOST_ASSERT(k_lifo_init(&lifo, sPool, sizeof(sPool)) == 0, "init");
+    K_HOST_ASSERT(k_lifo_init(&lifo, (char *)sPool + 1, 16) == -EINVAL, "misaligned region");
+    /* the index half of the head must hold max_idx + 1 */
+    K_HOST_ASSERT(k_lifo_init(&lifo, sPool,
+                              ((size_t)1 << (sizeof(atomic_t) * 4U)) * sizeof(void *)) == -EINVAL,
+                  "oversized region");
+    /* last word of the region is a valid node */
+    K_HOST_ASSERT(k_lifo_init(&lifo, sPool, sizeof(sPool)) == 0, "init");
+    k_lifo_push(&lifo, (char *)sPool + sizeof(sPool) - sizeof(void *));
+    K_HOST_ASSERT(k_lifo_pop(&lifo) == (char *)sPool + sizeof(sPool) - sizeof(void *), "last");
+}
+
+/*
+ * Pop A (successor B) is preempted before its CAS; meanwhile A and B are
+ * popped and A pushed back. The head holds A again but its tag moved on,
+ * so the stale CAS, replayed here, must fail.
+ */
+static void test_aba(void) {
+    atomic_t stale;
+
+    k_lifo_push(&sLifo, &sPool[1]);
+    k_lifo_push(&sLifo, &sPool[0]);
+    stale = atomic_get(&sLifo.head);
+
+    K_HOST_ASSERT(k_lifo_pop(&sLifo) == &sPool[0] && k_lifo_pop(&sLifo) == &sPool[1], "pop");
+    k_lifo_push(&sLifo, &sPool[0]);
+
+    K_HOST_ASSERT(atomic_get(&sLifo.head) != stale, "head value repeated after pop/pop/push");
+    K_HOST_ASSERT(!atomic_cas(&sLifo.head, stale, stale + 1), "stale CAS succeeded");
+    K_HOST_ASSERT(k_lifo_pop(&sLifo) == &sPool[0] && k_lifo_is_empty(&sLifo), "state");
+}
+
+/* every node popped must be owned by nobody, a node handed out twice
+ * (what an ABA corruption turns into) trips the owner check
+ */
+static void *stress_thread(void *arg) {
+    atomic_t id = (atomic_t)(intptr_t)arg + 1;
+    struct node *held[4];
+
+    for (int i = 0; i < LOOPS; i++) {
+        int n = 1 + i % 4;
+        int got = 0;
+
+        for (; got < n; got++) {
+            held[got] = k_lifo_pop(&sLifo);
+            if (held[got] == NULL) {
+                break;
+            }
+            K_HOST_ASSERT(atomic_cas(&held[got]->owner, 0, id), "node %d popped twice",
+                          (int)(held[got] - sPool));
+        }
+        while (got > 0) {
+            got--;
+            K_HOST_ASSERT(atomic_cas(&held[got]->owner, id, 0), "owner changed");
+            k_lifo_push(&sLifo, held[got]);
+        }
+        if ((i & 1023) == 0) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void test_stress(void) {
+    int count = 0;
+
+    for (int i = 0; i < NODES; i++) {
+        sPool[i].owner = 0;
+        k_lifo_push(&sLifo, &sPool[i]);
+    }
+    k_host_run_threads(THREADS, stress_thread);
+
+    while (k_lifo_pop(&sLifo) != NULL) {
+        count++;
+    }
+    K_HOST_ASSERT(count == NODES, "%d of %d nodes left", count, NODES);
+}
+
+static void *bench_thread(void *arg) {
+    ARG_UNUSED(arg);
+    for (int i = 0; i < LOOPS * 4; i++) {
+        void *node = k_lifo_pop(&sLifo);
+
+        if (node != NULL) {
+            k_lifo_push(&sLifo, node);
+        }
+    }
+    return NULL;
+}
+
+static void bench(int threads) {
+    uint64_t t0;
+
+    for (int i = 0; i < NODES; i++) {
+        k_lifo_push(&sLifo, &sPool[i]);
+    }
+    t0 = k_host_ns();
+    k_host_run_threads(threads, bench_thread);
+    printf("k_lifo pop+push %d thread(s): %6.1f Mpairs/s\n", threads,
+           (double)threads * LOOPS * 4 * 1e3 / (double)(k_host_ns() - t0));
+    while (k_lifo_pop(&sLifo) != NULL) {
+    }
+}
+
+int main(int argc, char **argv) {
+    test_basic();
+    test_aba();
+    test_stress();
+    K_HOST_PASS();
+
+    if (k_host_bench(argc, argv)) {
+        bench(1);
+        bench(THREADS);
+    }
+    return 0;
+}
@@ -0,0 +1,134 @@
+/*
+ * @Date: 2026-10-22 12:51:09
+ * @FilePath: \Openy_Framework\tests\host\test_load.c
+ * @Description: K_CONFIG_LOAD: cycles charged to the running activity,
+ * nested switches, the per-second history and its windows, and two
+ * cores measured apart
+ */
+#include "k_host.h"
+
+/* host cycles are nanoseconds */
+#define SPIN_CYCLES 2000000U
+
+static void spin(uint32_t cycles) {
+    uint32_t start = k_cycle_get_32();
+
+    while (k_cycle_get_32() - start < cycles) {
+    }
+}
+
+/* a timeout waits one tick more than asked, so does the sampling */
+static void next_second(void) { sys_clock_announce((int32_t)k_ms_to_ticks_ceil32(1000) + 1); }
+
+static void test_args(void) {
+    struct k_load_stats stats;
+
+    K_HOST_ASSERT(k_load_get(-1, 1, &stats) == -EINVAL && k_load_get(Z_NUM_CPUS, 1, &stats) ==
+                      -EINVAL, "cpu");
+    K_HOST_ASSERT(k_load_get(0, 0, &stats) == -EINVAL &&
+                      k_load_get(0, K_CONFIG_LOAD_HISTORY + 1U, &stats) == -EINVAL,
+                  "window");
+}
+
+static void test_charge(void) {
+    struct k_load_stats stats;
+    uint32_t pm;
+
+    k_load_init();
+    K_HOST_ASSERT(k_load_get(0, 1, &stats) == 0 && stats.seconds == 0U &&
+                      stats.total_cycles == 0U,
+                  "nothing sampled yet");
+    K_HOST_ASSERT(k_load_permille(0, 1) == 0U, "permille before a sample");
+
+    {
+        K_LOAD_ENTER(work, K_LOAD_WORK);
+        spin(SPIN_CYCLES);
+        {
+            /* preempted by the tick, taken out of the handler's time */
+            K_LOAD_ENTER(timer, K_LOAD_TIMER);
+            spin(10U * SPIN_CYCLES);
+            K_LOAD_EXIT(timer);
+        }
+        K_LOAD_EXIT(work);
+    }
+    {
+        K_LOAD_ENTER(idle, K_LOAD_IDLE);
+        spin(3U * SPIN_CYCLES);
+        K_LOAD_EXIT(idle);
+    }
+    next_second();
+
+    K_HOST_ASSERT(k_load_get(0, 10, &stats) == 0 && stats.seconds == 1U, "seconds %u",
+                  stats.seconds);
+    K_HOST_ASSERT(stats.cycles[K_LOAD_WORK] >= SPIN_CYCLES &&
+                      stats.cycles[K_LOAD_WORK] < 5U * SPIN_CYCLES,
+                  "work %llu", (unsigned long long)stats.cycles[K_LOAD_WORK]);
+    K_HOST_ASSERT(stats.cycles[K_LOAD_TIMER] >= 10U * SPIN_CYCLES, "timer");
+    K_HOST_ASSERT(stats.cycles[K_LOAD_IDLE] >= 3U * SPIN_CYCLES, "idle");
+    K_HOST_ASSERT(stats.cycles[K_LOAD_MSGQ] == 0U && stats.cycles[K_LOAD_HSM] == 0U, "others");
+    K_HOST_ASSERT(stats.total_cycles == stats.cycles[K_LOAD_OTHER] + stats.cycles[K_LOAD_WORK] +
+                                            stats.cycles[K_LOAD_MSGQ] + stats.cycles[K_LOAD_HSM] +
+                                            stats.cycles[K_LOAD_TIMER] + stats.cycles[K_LOAD_IDLE],
+                  "total");
+    pm = k_load_permille(0, 1);
+    K_HOST_ASSERT(pm == (uint32_t)(1000U - stats.cycles[K_LOAD_IDLE] * 1000U / stats.total_cycles),
+                  "permille %u", pm);
+    K_HOST_ASSERT(pm > 0U && pm < 1000U, "permille %u", pm);
+}
+
+static void test_history(void) {
+    struct k_load_stats one, all;
+
+    k_load_init();
+    for (uint32_t s = 0; s < K_CONFIG_LOAD_HISTORY + 5U; s++) {
+        K_LOAD_ENTER(hsm, K_LOAD_HSM);
+        /* only the last second carries HSM time */
+        if (s == K_CONFIG_LOAD_HISTORY + 4U) {
+            spin(SPIN_CYCLES);
+        }
+        K_LOAD_EXIT(hsm);
+        next_second();
+    }
+
+    K_HOST_ASSERT(k_load_get(0, K_CONFIG_LOAD_HISTORY, &all) == 0 &&
+                      all.seconds == K_CONFIG_LOAD_HISTORY,
+                  "seconds %u", all.seconds);
+    K_HOST_ASSERT(k_load_get(0, 1, &one) == 0 && one.seconds == 1U, "seconds %u", one.seconds);
+    K_HOST_ASSERT(one.cycles[K_LOAD_HSM] >= SPIN_CYCLES && all.total_cycles >= one.total_cycles,
+                  "hsm %llu", (unsigned long long)one.cycles[K_LOAD_HSM]);
+    K_HOST_ASSERT(all.cycles[K_LOAD_HSM] - one.cycles[K_LOAD_HSM] < SPIN_CYCLES,
+                  "older seconds hold hsm time");
+}
+
+static void *core_thread(void *arg) {
+    int cpu = k_cpu_id();
+    uint8_t cat = cpu == 0 ? K_LOAD_WORK : K_LOAD_MSGQ;
+    struct k_load_stats stats;
+
+    ARG_UNUSED(arg);
+    k_load_init();
+    {
+        K_LOAD_ENTER(prev, cat);
+        spin(SPIN_CYCLES);
+        K_LOAD_EXIT(prev);
+    }
+    next_second();
+
+    /* each core's handlers are charged on that core only */
+    K_HOST_ASSERT(k_load_get(cpu, 1, &stats) == 0 && stats.seconds == 1U, "cpu%d", cpu);
+    K_HOST_ASSERT(stats.cycles[cat] >= SPIN_CYCLES, "cpu%d busy", cpu);
+    K_HOST_ASSERT(stats.cycles[cpu == 0 ? K_LOAD_MSGQ : K_LOAD_WORK] == 0U, "cpu%d other", cpu);
+    return NULL;
+}
+
+static void test_cores(void) { k_host_run_threads(2, core_thread); }
+
+int main(void) {
+    test_args();
+    test_charge();
+    test_history();
+    test_cores();
+
+    K_HOST_PASS();
+    return 0;
+}
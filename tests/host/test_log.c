@@ -0,0 +1,249 @@
+/*
+ * @Date: 2026-10-22 11:02:37
+ * @FilePath: \Openy_Framework\tests\host\test_log.c
+ * @Description: K_CONFIG_LOG_DEFERRED: argument packing and formatting,
+ * truncated messages, a full ring and its dropped report, rate limiting
+ * shared by two cores, then several cores logging while one drains
+ */
+#include "k_host.h"
+
+#define STRESS_PRODUCERS 4
+#define STRESS_MSGS      50000
+#define RL_CALLS         20000
+
+static char sLine[K_CONFIG_LOG_LINE_SIZE + 1];
+static size_t sLen;
+static bool sStress;
+static uint32_t sStressSeen[STRESS_PRODUCERS];
+static uint32_t sStressLines;
+static uint32_t sStressDropped;
+static atomic_t sProducersDone;
+
+static void stress_line(const char *line) {
+    unsigned int id, seq, dropped;
+
+    if (sscanf(line, "[INFO] p%u %u", &id, &seq) == 2) {
+        K_HOST_ASSERT(id < STRESS_PRODUCERS && seq < STRESS_MSGS, "line %s", line);
+        /* a producer's messages keep their order, drops only leave gaps */
+        K_HOST_ASSERT(seq + 1U > sStressSeen[id], "p%u %u after %u", id, seq, sStressSeen[id]);
+        sStressSeen[id] = seq + 1U;
+        sStressLines++;
+    } else {
+        K_HOST_ASSERT(sscanf(line, "[ERROR] %u log messages dropped", &dropped) == 1, "line %s",
+                      line);
+        sStressDropped += dropped;
+    }
+}
+
+static void capture_write(const struct k_log_backend *backend, const char *data, size_t len) {
+    ARG_UNUSED(backend);
+    K_HOST_ASSERT(len <= K_CONFIG_LOG_LINE_SIZE && data[len - 1] == '\n', "len %zu", len);
+    memcpy(sLine, data, len);
+    sLine[len] = '\0';
+    sLen = len;
+    if (sStress) {
+        stress_line(sLine);
+    }
+}
+
+static struct k_log_backend sCapture = {
+    .write = capture_write,
+};
+
+static void expect_line(const char *want) {
+    K_HOST_ASSERT(k_log_process(), "no line, expected %s", want);
+    K_HOST_ASSERT(strcmp(sLine, want) == 0, "got %s expected %s", sLine, want);
+}
+
+static void expect_empty(void) { K_HOST_ASSERT(!k_log_process(), "extra line %s", sLine); }
+
+static struct k_log_overflow overflow_delta(const struct k_log_overflow *before) {
+    struct k_log_overflow now;
+
+    k_log_overflow_get(&now);
+    now.dropped -= before->dropped;
+    now.truncated -= before->truncated;
+    return now;
+}
+
+static void test_format(void) {
+    struct k_log_overflow start, d;
+
+    k_log_overflow_get(&start);
+    /* exactly K_CONFIG_LOG_MSG_WORDS words each on the host */
+    K_LOG_INFO("i=%d u=%u x=%#x l=%ld ll=%lld z=%zu", -3, 7U, 255, -100000L, 1LL << 40,
+               (size_t)9);
+    K_LOG_DEBUG("s=%s c=%c w=%*d p=%.*f %% end", "str", 'q', 5, 42, 2, 3.14159);
+    K_LOG_ERROR("no args, 100%%");
+    expect_line("[INFO] i=-3 u=7 x=0xff l=-100000 ll=1099511627776 z=9\n");
+    expect_line("[DEBUG] s=str c=q w=   42 p=3.14 % end\n");
+    expect_line("[ERROR] no args, 100%\n");
+    expect_empty();
+
+    d = overflow_delta(&start);
+    K_HOST_ASSERT(d.dropped == 0U && d.truncated == 0U, "dropped %u truncated %u", d.dropped,
+                  d.truncated);
+}
+
+static void test_truncated(void) {
+    char longer[2 * K_CONFIG_LOG_LINE_SIZE];
+    struct k_log_overflow start, d;
+
+    memset(longer, 'a', sizeof(longer) - 1U);
+    longer[sizeof(longer) - 1U] = '\0';
+
+    k_log_overflow_get(&start);
+    /* the 7th word does not fit, the line stops at its conversion */
+    K_LOG_ERROR("a %d %d %d %d %d %d b %d c", 1, 2, 3, 4, 5, 6, 7);
+    expect_line("[ERROR] a 1 2 3 4 5 6 b \n");
+    /* cut to the line buffer, the newline kept */
+    K_LOG_INFO("%s", longer);
+    K_HOST_ASSERT(k_log_process() && sLen == K_CONFIG_LOG_LINE_SIZE - 1U, "len %zu", sLen);
+    K_HOST_ASSERT(strncmp(sLine, "[INFO] aaaa", 11) == 0 && sLine[sLen - 2] == 'a', "%s", sLine);
+    /* long double is not carried */
+    K_LOG_INFO("v=%Lf w=%d", 1.0L, 2);
+    expect_line("[INFO] v=\n");
+    expect_empty();
+
+    d = overflow_delta(&start);
+    K_HOST_ASSERT(d.dropped == 0U && d.truncated == 3U, "dropped %u truncated %u", d.dropped,
+                  d.truncated);
+}
+
+static void test_full(void) {
+    char want[32];
+
+    /* twice, the second round starts mid-ring and laps */
+    for (int round = 0; round < 2; round++) {
+        struct k_log_overflow start, d;
+
+        k_log_overflow_get(&start);
+        for (int i = 0; i < K_CONFIG_LOG_MSGS + 3; i++) {
+            K_LOG_INFO("n %d", i);
+        }
+        d = overflow_delta(&start);
+        K_HOST_ASSERT(d.dropped == 3U && d.truncated == 0U, "dropped %u truncated %u", d.dropped,
+                      d.truncated);
+
+        /* the drop is reported first, then the messages that made it */
+        expect_line("[ERROR] 3 log messages dropped\n");
+        for (int i = 0; i < K_CONFIG_LOG_MSGS; i++) {
+            snprintf(want, sizeof(want), "[INFO] n %d\n", i);
+            expect_line(want);
+        }
+        expect_empty();
+        K_LOG_INFO("after");
+        expect_line("[INFO] after\n");
+    }
+}
+
+static struct k_log_ratelimit sSharedRl;
+static atomic_t sRlPassed;
+
+static void *rl_thread(void *arg) {
+    ARG_UNUSED(arg);
+    for (int i = 0; i < RL_CALLS; i++) {
+        if (z_log_ratelimit(&sSharedRl)) {
+            (void)atomic_inc(&sRlPassed);
+        }
+        if ((i & 255) == 0) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+/* one call site, one window state */
+static void rl_burst(void) {
+    for (int i = 0; i < 3 * K_CONFIG_LOG_RATELIMIT_BURST; i++) {
+        K_LOG_INFO_RATELIMIT("rl %d", i);
+    }
+}
+
+static void test_ratelimit(void) {
+    char want[64];
+
+    /* both cores are still at tick 0, so all calls fall in one window */
+    k_host_run_threads(2, rl_thread);
+    K_HOST_ASSERT(atomic_get(&sRlPassed) == K_CONFIG_LOG_RATELIMIT_BURST, "passed %ld",
+                  (long)atomic_get(&sRlPassed));
+    K_HOST_ASSERT(sSharedRl.count == K_CONFIG_LOG_RATELIMIT_BURST &&
+                      sSharedRl.missed == 2 * RL_CALLS - K_CONFIG_LOG_RATELIMIT_BURST,
+                  "count %u missed %u", sSharedRl.count, sSharedRl.missed);
+
+    /* a burst gets through, the rest is suppressed and reported later */
+    rl_burst();
+    for (int i = 0; i < K_CONFIG_LOG_RATELIMIT_BURST; i++) {
+        snprintf(want, sizeof(want), "[INFO] rl %d\n", i);
+        expect_line(want);
+    }
+    expect_empty();
+
+    sys_clock_announce((int32_t)k_ms_to_ticks_ceil32(K_CONFIG_LOG_RATELIMIT_MS));
+    rl_burst();
+    snprintf(want, sizeof(want), "[ERROR] %d messages suppressed by rate limit\n",
+             2 * K_CONFIG_LOG_RATELIMIT_BURST);
+    expect_line(want);
+    for (int i = 0; i < K_CONFIG_LOG_RATELIMIT_BURST; i++) {
+        snprintf(want, sizeof(want), "[INFO] rl %d\n", i);
+        expect_line(want);
+    }
+    expect_empty();
+}
+
+/* thread 0 drains the ring, the others log into it */
+static void *stress_thread(void *arg) {
+    int id = (int)(intptr_t)arg;
+
+    if (id == 0) {
+        for (;;) {
+            bool done = atomic_get(&sProducersDone) == STRESS_PRODUCERS;
+
+            if (!k_log_process()) {
+                if (done) {
+                    break;
+                }
+                sched_yield();
+            }
+        }
+        return NULL;
+    }
+
+    for (unsigned int seq = 0; seq < STRESS_MSGS; seq++) {
+        K_LOG_INFO("p%u %u", (unsigned int)(id - 1), seq);
+        if ((seq & 63U) == 0U) {
+            sched_yield();
+        }
+    }
+    (void)atomic_inc(&sProducersDone);
+    return NULL;
+}
+
+static void test_stress(void) {
+    struct k_log_overflow start, d;
+
+    k_log_overflow_get(&start);
+    sStress = true;
+    k_host_run_threads(1 + STRESS_PRODUCERS, stress_thread);
+    sStress = false;
+    expect_empty();
+
+    d = overflow_delta(&start);
+    K_HOST_ASSERT(d.dropped == sStressDropped && d.truncated == 0U,
+                  "dropped %u reported %u truncated %u", d.dropped, sStressDropped, d.truncated);
+    K_HOST_ASSERT(sStressLines + sStressDropped == STRESS_PRODUCERS * STRESS_MSGS,
+                  "lines %u dropped %u", sStressLines, sStressDropped);
+}
+
+int main(void) {
+    k_log_backend_add(&sCapture);
+
+    test_format();
+    test_truncated();
+    test_full();
+    test_ratelimit();
+    test_stress();
+
+    K_HOST_PASS();
+    return 0;
+}
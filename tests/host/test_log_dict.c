@@ -0,0 +1,116 @@
+/*
+ * @Date: 2026-10-22 11:48:16
+ * @FilePath: \Openy_Framework\tests\host\test_log_dict.c
+ * @Description: K_CONFIG_LOG_DICTIONARY records: header, argument words
+ * by class, too many arguments and the dropped record of a full ring
+ */
+#include "k_host.h"
+
+/* argument words a record holds on the host, 32-bit ones */
+#define DICT_WORDS (K_CONFIG_LOG_MSG_WORDS * sizeof(uintptr_t) / sizeof(uint32_t))
+
+static struct k_log_dict_hdr sHdr;
+static uint32_t sWords[DICT_WORDS];
+
+static void capture_write(const struct k_log_backend *backend, const char *data, size_t len) {
+    ARG_UNUSED(backend);
+    K_HOST_ASSERT(len >= sizeof(sHdr), "len %zu", len);
+    memcpy(&sHdr, data, sizeof(sHdr));
+    K_HOST_ASSERT(sHdr.magic == K_LOG_DICT_MAGIC && sHdr.reserved == 0U, "magic %#x", sHdr.magic);
+    K_HOST_ASSERT(len == sizeof(sHdr) + sHdr.words * sizeof(uint32_t) && sHdr.words <= DICT_WORDS,
+                  "len %zu words %u", len, sHdr.words);
+    memcpy(sWords, &data[sizeof(sHdr)], sHdr.words * sizeof(uint32_t));
+}
+
+static struct k_log_backend sCapture = {
+    .write = capture_write,
+};
+
+static void expect_record(uint8_t level, uint8_t words) {
+    K_HOST_ASSERT(k_log_process(), "no record");
+    K_HOST_ASSERT(sHdr.level == level && sHdr.words == words, "level %u words %u", sHdr.level,
+                  sHdr.words);
+}
+
+static uint64_t word64(int i) {
+    uint64_t v;
+
+    memcpy(&v, &sWords[i], sizeof(v));
+    return v;
+}
+
+/* the same call site for every message, so the same format id */
+static void log_n(int i) { K_LOG_INFO("n %d", i); }
+
+static void test_args(void) {
+    double d;
+    uint32_t id;
+
+    K_LOG_INFO("d %d %lld %f", 7, -2LL, 0.5);
+    expect_record(K_LOG_LEVEL_INFO, 5);
+    K_HOST_ASSERT(sHdr.fmt != 0U, "no format id");
+    K_HOST_ASSERT(sWords[0] == 7U && word64(1) == (uint64_t)-2LL, "int words");
+    memcpy(&d, &sWords[3], sizeof(d));
+    K_HOST_ASSERT(d == 0.5, "double %f", d);
+
+    /* a float argument is promoted and goes as a double */
+    K_LOG_ERROR("f %f %u", 1.5f, 3U);
+    expect_record(K_LOG_LEVEL_ERROR, 3);
+    memcpy(&d, &sWords[0], sizeof(d));
+    K_HOST_ASSERT(d == 1.5 && sWords[2] == 3U, "float %f", d);
+
+    K_LOG_DEBUG("no args");
+    expect_record(K_LOG_LEVEL_DEBUG, 0);
+
+    log_n(1);
+    expect_record(K_LOG_LEVEL_INFO, 1);
+    id = sHdr.fmt;
+    log_n(2);
+    expect_record(K_LOG_LEVEL_INFO, 1);
+    K_HOST_ASSERT(sHdr.fmt == id && sWords[0] == 2U, "format id %#x then %#x", id, sHdr.fmt);
+    K_HOST_ASSERT(!k_log_process(), "extra record");
+}
+
+static void test_truncated(void) {
+    struct k_log_overflow before, after;
+
+    /* 8 doubles need 16 words, the record keeps the ones that fit whole */
+    k_log_overflow_get(&before);
+    K_LOG_INFO("%f %f %f %f %f %f %f %f", 1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0);
+    expect_record(K_LOG_LEVEL_INFO, DICT_WORDS / 2U * 2U);
+    for (uint32_t i = 0; i < DICT_WORDS / 2U; i++) {
+        double d;
+
+        memcpy(&d, &sWords[2U * i], sizeof(d));
+        K_HOST_ASSERT(d == (double)(i + 1U), "arg %u = %f", i, d);
+    }
+    k_log_overflow_get(&after);
+    K_HOST_ASSERT(after.truncated - before.truncated == 1U && after.dropped == before.dropped,
+                  "truncated %u", after.truncated - before.truncated);
+}
+
+static void test_full(void) {
+    for (int i = 0; i < K_CONFIG_LOG_MSGS + 2; i++) {
+        log_n(i);
+    }
+
+    /* the dropped record first, its word is the count */
+    expect_record(K_LOG_DICT_DROPPED, 1);
+    K_HOST_ASSERT(sWords[0] == 2U && sHdr.fmt == 0U, "dropped %u", sWords[0]);
+    for (int i = 0; i < K_CONFIG_LOG_MSGS; i++) {
+        expect_record(K_LOG_LEVEL_INFO, 1);
+        K_HOST_ASSERT(sWords[0] == (uint32_t)i, "n %u expected %d", sWords[0], i);
+    }
+    K_HOST_ASSERT(!k_log_process(), "extra record");
+}
+
+int main(void) {
+    k_log_backend_add(&sCapture);
+
+    test_args();
+    test_truncated();
+    test_full();
+
+    K_HOST_PASS();
+    return 0;
+}
@@ -0,0 +1,161 @@
+/*
+ * @Date: 2026-10-21 11:02:44
+ * @FilePath: \Openy_Framework\tests\host\test_mem_slab.c
+ * @Description: k_mem_slab exhaustion, reuse and statistics, and several
+ * threads allocating from one slab; "bench" adds alloc+free pairs/sec
+ * under contention, against glibc malloc
+ */
+#include "k_host.h"
+
+#define BLOCK   32
+#define BLOCKS  48
+#define THREADS 4
+#define LOOPS   200000
+
+K_MEM_SLAB_DEFINE(sSlab, BLOCK, BLOCKS, 8);
+
+static void test_basic(void) {
+    static char __attribute__((__aligned__(8))) buf[BLOCK * 4];
+    void *blocks[BLOCKS];
+    void *mem;
+    k_mem_slab_t slab;
+
+    K_HOST_ASSERT(k_mem_slab_init(&slab, buf, 3, 4) == -EINVAL, "block size below a pointer");
+    K_HOST_ASSERT(k_mem_slab_init(&slab, buf + 1, BLOCK, 2) == -EINVAL, "misaligned buffer");
+    K_HOST_ASSERT(k_mem_slab_init(&slab, buf, BLOCK, 4) == 0, "init");
+    K_HOST_ASSERT(k_mem_slab_alloc(&slab, &mem) == 0 && mem == buf, "first block");
+    k_mem_slab_free(&slab, mem);
+
+    /* statically defined slab, no init */
+    for (int i = 0; i < BLOCKS; i++) {
+        K_HOST_ASSERT(k_mem_slab_alloc(&sSlab, &blocks[i]) == 0, "alloc %d", i);
+        K_HOST_ASSERT((char *)blocks[i] == sSlab.buffer + i * BLOCK, "fresh order %d", i);
+    }
+    K_HOST_ASSERT(k_mem_slab_alloc(&sSlab, &mem) == -ENOMEM && mem == NULL, "exhausted");
+    K_HOST_ASSERT(k_mem_slab_num_used_get(&sSlab) == BLOCKS &&
+                      k_mem_slab_num_free_get(&sSlab) == 0,
+                  "used %u", k_mem_slab_num_used_get(&sSlab));
+
+    /* freed blocks come back most recent first */
+    k_mem_slab_free(&sSlab, blocks[3]);
+    k_mem_slab_free(&sSlab, blocks[7]);
+    K_HOST_ASSERT(k_mem_slab_alloc(&sSlab, &mem) == 0 && mem == blocks[7], "reuse");
+    K_HOST_ASSERT(k_mem_slab_alloc(&sSlab, &mem) == 0 && mem == blocks[3], "reuse");
+
+    for (int i = 0; i < BLOCKS; i++) {
+        k_mem_slab_free(&sSlab, blocks[i]);
+    }
+    K_HOST_ASSERT(k_mem_slab_num_used_get(&sSlab) == 0, "all freed");
+    K_HOST_ASSERT(k_mem_slab_max_used_get(&sSlab) == BLOCKS, "max %u",
+                  k_mem_slab_max_used_get(&sSlab));
+    k_mem_slab_runtime_stats_reset_max(&sSlab);
+    K_HOST_ASSERT(k_mem_slab_max_used_get(&sSlab) == 0, "reset max");
+}
+
+/* each thread fills its blocks with its id and checks nobody else wrote
+ * them before freeing, a block handed out twice shows up as a mismatch
+ */
+static void *stress_thread(void *arg) {
+    uint32_t id = (uint32_t)(intptr_t)arg + 1U;
+    uint32_t *held[8];
+
+    for (int i = 0; i < LOOPS; i++) {
+        int n = 1 + (int)((id * 7U + (uint32_t)i) % 8U);
+        int got = 0;
+
+        while (got < n && k_mem_slab_alloc(&sSlab, (void **)&held[got]) == 0) {
+            for (int w = 0; w < BLOCK / 4; w++) {
+                held[got][w] = id;
+            }
+            got++;
+        }
+        if (got == 0) {
+            sched_yield();
+        }
+        while (got > 0) {
+            got--;
+            for (int w = 0; w < BLOCK / 4; w++) {
+                K_HOST_ASSERT(held[got][w] == id, "block %p shared", (void *)held[got]);
+            }
+            k_mem_slab_free(&sSlab, held[got]);
+        }
+    }
+    return NULL;
+}
+
+static void test_stress(void) {
+    void *blocks[BLOCKS];
+    void *mem;
+
+    k_host_run_threads(THREADS, stress_thread);
+    K_HOST_ASSERT(k_mem_slab_num_used_get(&sSlab) == 0, "used %u after stress",
+                  k_mem_slab_num_used_get(&sSlab));
+    K_HOST_ASSERT(k_mem_slab_max_used_get(&sSlab) <= BLOCKS, "max %u",
+                  k_mem_slab_max_used_get(&sSlab));
+
+    /* every block still reachable exactly once */
+    for (int i = 0; i < BLOCKS; i++) {
+        K_HOST_ASSERT(k_mem_slab_alloc(&sSlab, &blocks[i]) == 0, "alloc %d", i);
+        for (int j = 0; j < i; j++) {
+            K_HOST_ASSERT(blocks[i] != blocks[j], "block %p twice", blocks[i]);
+        }
+    }
+    K_HOST_ASSERT(k_mem_slab_alloc(&sSlab, &mem) == -ENOMEM, "extra block");
+    for (int i = 0; i < BLOCKS; i++) {
+        k_mem_slab_free(&sSlab, blocks[i]);
+    }
+}
+
+static void *bench_slab_thread(void *arg) {
+    void *mem[4];
+
+    ARG_UNUSED(arg);
+    for (int i = 0; i < LOOPS * 5; i++) {
+        for (int j = 0; j < 4; j++) {
+            (void)k_mem_slab_alloc(&sSlab, &mem[j]);
+        }
+        for (int j = 0; j < 4; j++) {
+            if (mem[j] != NULL) {
+                k_mem_slab_free(&sSlab, mem[j]);
+            }
+        }
+    }
+    return NULL;
+}
+
+static void *bench_malloc_thread(void *arg) {
+    void *mem[4];
+
+    ARG_UNUSED(arg);
+    for (int i = 0; i < LOOPS * 5; i++) {
+        for (int j = 0; j < 4; j++) {
+            mem[j] = malloc(BLOCK);
+        }
+        for (int j = 0; j < 4; j++) {
+            free(mem[j]);
+        }
+    }
+    return NULL;
+}
+
+static void bench(const char *name, void *(*fn)(void *), int threads) {
+    uint64_t t0 = k_host_ns();
+
+    k_host_run_threads(threads, fn);
+    printf("%-14s %d thread(s): %6.1f Mpairs/s\n", name, threads,
+           (double)threads * LOOPS * 5 * 4 * 1e3 / (double)(k_host_ns() - t0));
+}
+
+int main(int argc, char **argv) {
+    test_basic();
+    test_stress();
+    K_HOST_PASS();
+
+    if (k_host_bench(argc, argv)) {
+        bench("k_mem_slab", bench_slab_thread, 1);
+        bench("k_mem_slab", bench_slab_thread, THREADS);
+        bench("glibc malloc", bench_malloc_thread, 1);
+        bench("glibc malloc", bench_malloc_thread, THREADS);
+    }
+    return 0;
+}
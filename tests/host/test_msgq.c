@@ -0,0 +1,292 @@
+/*
+ * @Date: 2026-10-21 10:05:51
+ * @FilePath: \Openy_Framework\tests\host\test_msgq.c
+ * @Description: k_msgq_put_n()/k_msgq_get_n() against the single message
+ * calls at every ring offset, the wrap-around split copy, overwrite mode
+ * and a producer/consumer pair; K_MSGQ_TYPED_DEFINE() with producers on
+ * several cores; the notify pair replaced while puts run on another core;
+ * "bench" adds msgs/sec per batch size
+ */
+#include "k_host.h"
+
+#define DEPTH 7
+
+K_MSGQ_DEFINE(sQ, sizeof(uint32_t), DEPTH, 4);
+K_MSGQ_DEFINE(sBenchQ, sizeof(uint32_t), 64, 4);
+
+struct typed_msg {
+    uint32_t producer;
+    uint32_t seq;
+};
+
+K_MSGQ_TYPED_DEFINE(sTypedQ, struct typed_msg, 8);
+
+static void test_wrap(void) {
+    uint32_t in[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    uint32_t out[8] = {0};
+    uint32_t x;
+
+    /* read and write pointers two slots before the end of the buffer */
+    for (uint32_t i = 0; i < DEPTH - 2U; i++) {
+        K_HOST_ASSERT(k_msgq_put(&sQ, &i) == 0 && k_msgq_get(&sQ, &x) == 0 && x == i, "prime");
+    }
+
+    /* 5 messages: 2 up to the buffer end, 3 from its start */
+    K_HOST_ASSERT(k_msgq_put_n(&sQ, in, 5) == 5, "put_n");
+    K_HOST_ASSERT(sQ.write_ptr == sQ.buffer_start + 3 * sizeof(uint32_t), "write_ptr wrapped");
+    /* only 2 of the 8 fit */
+    K_HOST_ASSERT(k_msgq_put_n(&sQ, in + 5, 3) == 2, "put_n full");
+    K_HOST_ASSERT(k_msgq_put_n(&sQ, in, 1) == 0, "put_n on full");
+
+    K_HOST_ASSERT(k_msgq_get_n(&sQ, out, 8) == 7, "get_n");
+    for (uint32_t i = 0; i < 7; i++) {
+        K_HOST_ASSERT(out[i] == i + 1U, "out[%u] = %u", i, out[i]);
+    }
+    K_HOST_ASSERT(k_msgq_get_n(&sQ, out, 8) == 0 && k_msgq_get(&sQ, &x) != 0, "empty");
+}
+
+/* every batch size from every ring offset, against a reference sequence */
+static void test_offsets(void) {
+    uint32_t seq_in = 0, seq_out = 0;
+    uint32_t buf[DEPTH + 2];
+
+    for (uint32_t offset = 0; offset < DEPTH; offset++) {
+        for (uint32_t n = 1; n <= DEPTH + 2U; n++) {
+            uint32_t used = offset % 3U;
+            uint32_t got;
+
+            k_msgq_purge(&sQ);
+            /* move the pointers to offset, leave 'used' messages queued */
+            for (uint32_t i = 0; i < offset; i++) {
+                K_HOST_ASSERT(k_msgq_put(&sQ, &i) == 0 && k_msgq_get(&sQ, &got) == 0, "move");
+            }
+            seq_out = seq_in;
+            for (uint32_t i = 0; i < used; i++) {
+                K_HOST_ASSERT(k_msgq_put(&sQ, &seq_in) == 0, "fill");
+                seq_in++;
+            }
+
+            for (uint32_t i = 0; i < n; i++) {
+                buf[i] = seq_in + i;
+            }
+            got = k_msgq_put_n(&sQ, buf, n);
+            K_HOST_ASSERT(got == MIN(n, DEPTH - used), "offset %u n %u put %u", offset, n, got);
+            seq_in += got;
+
+            memset(buf, 0, sizeof(buf));
+            got = k_msgq_get_n(&sQ, buf, n);
+            K_HOST_ASSERT(got == MIN(n, used + MIN(n, DEPTH - used)), "get %u", got);
+            for (uint32_t i = 0; i < got; i++) {
+                K_HOST_ASSERT(buf[i] == seq_out, "offset %u n %u: %u != %u", offset, n, buf[i],
+                              seq_out);
+                seq_out++;
+            }
+            while (k_msgq_get(&sQ, &got) == 0) {
+                K_HOST_ASSERT(got == seq_out, "tail %u != %u", got, seq_out);
+                seq_out++;
+            }
+            K_HOST_ASSERT(seq_out == seq_in, "lost messages");
+        }
+    }
+}
+
+static void test_overwrite(void) {
+    uint32_t in[DEPTH * 2], out[DEPTH];
+
+    for (uint32_t i = 0; i < DEPTH * 2U; i++) {
+        in[i] = i;
+    }
+    k_msgq_purge(&sQ);
+    k_msgq_set_overwrite(&sQ, true);
+    K_HOST_ASSERT(k_msgq_put_n(&sQ, in, 3) == 3, "put_n");
+    /* 3 queued + 2 * DEPTH new: only the newest DEPTH survive */
+    K_HOST_ASSERT(k_msgq_put_n(&sQ, in, DEPTH * 2) == DEPTH * 2, "overwrite put_n");
+    K_HOST_ASSERT(k_msgq_dropped_get(&sQ) == DEPTH + 3U, "dropped %u", k_msgq_dropped_get(&sQ));
+    K_HOST_ASSERT(k_msgq_get_n(&sQ, out, DEPTH) == DEPTH, "get_n");
+    for (uint32_t i = 0; i < DEPTH; i++) {
+        K_HOST_ASSERT(out[i] == DEPTH + i, "out[%u] = %u", i, out[i]);
+    }
+    k_msgq_set_overwrite(&sQ, false);
+}
+
+#define STREAM_MSGS 2000000U
+
+static void *stream_thread(void *arg) {
+    uint32_t buf[16];
+    uint32_t seq = 0;
+
+    if ((intptr_t)arg == 0) {
+        while (seq < STREAM_MSGS) {
+            uint32_t n = 1U + seq % 16U;
+
+            for (uint32_t i = 0; i < n; i++) {
+                buf[i] = seq + i;
+            }
+            n = k_msgq_put_n(&sBenchQ, buf, MIN(n, STREAM_MSGS - seq));
+            if (n == 0U) {
+                sched_yield();
+            }
+            seq += n;
+        }
+    } else {
+        while (seq < STREAM_MSGS) {
+            uint32_t n = k_msgq_get_n(&sBenchQ, buf, 1U + seq % 13U);
+
+            if (n == 0U) {
+                sched_yield();
+            }
+            for (uint32_t i = 0; i < n; i++, seq++) {
+                K_HOST_ASSERT(buf[i] == seq, "stream %u != %u", buf[i], seq);
+            }
+        }
+    }
+    return NULL;
+}
+
+#define TYPED_PRODUCERS 3
+#define TYPED_MSGS      200000U
+
+/* thread 0 consumes, the others put their own increasing sequence; a lost
+ * update of the shared indices shows up as a gap or a repeat
+ */
+static void *typed_thread(void *arg) {
+    uint32_t id = (uint32_t)(intptr_t)arg;
+    struct typed_msg msg;
+
+    if (id == 0U) {
+        uint32_t next[TYPED_PRODUCERS + 1] = {0};
+        uint32_t got = 0;
+
+        while (got < TYPED_PRODUCERS * TYPED_MSGS) {
+            if (sTypedQ_get(&msg) != 0) {
+                sched_yield();
+                continue;
+            }
+            K_HOST_ASSERT(msg.producer >= 1U && msg.producer <= TYPED_PRODUCERS &&
+                              msg.seq == next[msg.producer],
+                          "producer %u seq %u", msg.producer, msg.seq);
+            next[msg.producer]++;
+            got++;
+        }
+    } else {
+        msg.producer = id;
+        for (msg.seq = 0; msg.seq < TYPED_MSGS;) {
+            if (sTypedQ_put(&msg) == 0) {
+                msg.seq++;
+            } else {
+                sched_yield();
+            }
+        }
+    }
+    return NULL;
+}
+
+static void test_typed(void) {
+    struct typed_msg msg = {0, 0};
+
+    for (uint32_t i = 0; i < 8U; i++) {
+        K_HOST_ASSERT(sTypedQ_put(&msg) == 0, "put %u", i);
+    }
+    K_HOST_ASSERT(sTypedQ_put(&msg) == -ENOMEM && sTypedQ_num_used_get() == 8U, "full");
+    sTypedQ_purge();
+    K_HOST_ASSERT(sTypedQ_get(&msg) == -EINVAL, "purged");
+    k_host_run_threads(TYPED_PRODUCERS + 1, typed_thread);
+    K_HOST_ASSERT(sTypedQ_num_used_get() == 0U, "messages left");
+}
+
+#define NOTIFY_PUTS 200000U
+
+static atomic_t sNotifyA, sNotifyB;
+static atomic_t sNotifyStarted;
+static atomic_t sNotifyDone;
+
+/* each callback is installed with its own counter, a put that pairs one
+ * callback with the other's data shows up here
+ */
+static void notify_a(k_msgq_t *msgq, void *user_data) {
+    ARG_UNUSED(msgq);
+    K_HOST_ASSERT(user_data == &sNotifyA, "notify_a called with %p", user_data);
+    (void)atomic_inc(&sNotifyA);
+}
+
+static void notify_b(k_msgq_t *msgq, void *user_data) {
+    ARG_UNUSED(msgq);
+    K_HOST_ASSERT(user_data == &sNotifyB, "notify_b called with %p", user_data);
+    (void)atomic_inc(&sNotifyB);
+}
+
+static void *notify_thread(void *arg) {
+    uint32_t v = 0;
+
+    if ((intptr_t)arg == 0) {
+        while (atomic_get(&sNotifyStarted) == 0) {
+            sched_yield();
+        }
+        for (uint32_t i = 0; i < NOTIFY_PUTS; i++) {
+            if ((i % 1024U) == 0U) {
+                sched_yield();
+            }
+            (void)k_msgq_put(&sBenchQ, &v);
+            (void)k_msgq_put_n(&sBenchQ, &v, 1);
+            (void)k_msgq_get_n(&sBenchQ, &v, 2);
+        }
+        (void)atomic_set(&sNotifyDone, 1);
+    } else {
+        for (uint32_t i = 0; atomic_get(&sNotifyDone) == 0; i++) {
+            switch (i % 3U) {
+            case 0: k_msgq_set_notify(&sBenchQ, notify_a, &sNotifyA); break;
+            case 1: k_msgq_set_notify(&sBenchQ, notify_b, &sNotifyB); break;
+            default: k_msgq_set_notify(&sBenchQ, NULL, NULL); break;
+            }
+            (void)atomic_set(&sNotifyStarted, 1);
+        }
+    }
+    return NULL;
+}
+
+static void test_notify_race(void) {
+    k_host_run_threads(2, notify_thread);
+    k_msgq_set_notify(&sBenchQ, NULL, NULL);
+    K_HOST_ASSERT(sNotifyA + sNotifyB > 0, "no notify ran");
+}
+
+static void bench_batch(void) {
+    static const uint32_t batches[] = {1, 2, 4, 8, 16, 32};
+    uint32_t buf[32] = {0};
+    const uint32_t total = 8000000U;
+    uint64_t t0;
+
+    t0 = k_host_ns();
+    for (uint32_t i = 0; i < total; i++) {
+        (void)k_msgq_put(&sBenchQ, &buf[0]);
+        (void)k_msgq_get(&sBenchQ, &buf[0]);
+    }
+    printf("k_msgq_put/get       : %6.1f Mmsgs/s\n", total * 1e3 / (double)(k_host_ns() - t0));
+
+    for (size_t b = 0; b < ARRAY_SIZE(batches); b++) {
+        uint32_t n = batches[b];
+
+        t0 = k_host_ns();
+        for (uint32_t i = 0; i < total; i += n) {
+            (void)k_msgq_put_n(&sBenchQ, buf, n);
+            (void)k_msgq_get_n(&sBenchQ, buf, n);
+        }
+        printf("k_msgq_put_n/get_n %2u: %6.1f Mmsgs/s\n", n,
+               total * 1e3 / (double)(k_host_ns() - t0));
+    }
+}
+
+int main(int argc, char **argv) {
+    test_wrap();
+    test_offsets();
+    test_overwrite();
+    k_host_run_threads(2, stream_thread);
+    test_typed();
+    test_notify_race();
+    K_HOST_PASS();
+
+    if (k_host_bench(argc, argv)) {
+        bench_batch();
+    }
+    return 0;
+}
@@ -0,0 +1,104 @@
+/*
+ * @Date: 2026-10-21 14:20:37
+ * @FilePath: \Openy_Framework\tests\host\test_msgq_prio.c
+ * @Description: k_msgq_prio band order, limits, slot reuse, init checks
+ * and producers on several cores sharing the slot pool
+ */
+#include "k_host.h"
+
+#define SLOTS 6
+
+K_MSGQ_PRIO_DEFINE(sQ, sizeof(uint32_t), SLOTS, 4);
+
+static void test_bands(void) {
+    static char buf[4];
+    static uint16_t next[1];
+    k_msgq_prio_t q;
+    uint32_t v;
+    uint8_t band;
+
+    K_HOST_ASSERT(k_msgq_prio_init(&q, buf, next, 4, K_MSGQ_PRIO_NONE) == -EINVAL, "0xFFFF");
+    K_HOST_ASSERT(k_msgq_prio_init(&q, buf, next, 4, 1) == 0, "init");
+
+    K_HOST_ASSERT(k_msgq_prio_set_limit(&sQ, K_CONFIG_MSGQ_PRIO_BANDS, 1) == -EINVAL, "band");
+    K_HOST_ASSERT(k_msgq_prio_set_limit(&sQ, 3, 2) == 0, "limit");
+    for (v = 0; v < 3; v++) {
+        K_HOST_ASSERT(k_msgq_prio_put(&sQ, 3, &v) == (v < 2U ? 0 : -ENOMEM), "band 3 #%u", v);
+    }
+    v = 10;
+    K_HOST_ASSERT(k_msgq_prio_put(&sQ, 1, &v) == 0, "band 1");
+    v = 11;
+    K_HOST_ASSERT(k_msgq_prio_put(&sQ, 1, &v) == 0, "band 1");
+    v = 20;
+    K_HOST_ASSERT(k_msgq_prio_put(&sQ, 0, &v) == 0, "band 0");
+    v = 21;
+    K_HOST_ASSERT(k_msgq_prio_put(&sQ, 0, &v) == 0, "last slot");
+    K_HOST_ASSERT(k_msgq_prio_put(&sQ, 0, &v) == -ENOMEM, "pool full");
+
+    /* most urgent band first, FIFO within a band */
+    static const uint32_t expect[] = {20, 21, 10, 11, 0, 1};
+    static const uint8_t expect_band[] = {0, 0, 1, 1, 3, 3};
+
+    for (size_t i = 0; i < ARRAY_SIZE(expect); i++) {
+        K_HOST_ASSERT(k_msgq_prio_get(&sQ, &v, &band) == 0 && v == expect[i] &&
+                          band == expect_band[i],
+                      "get #%zu: %u band %u", i, v, band);
+    }
+    K_HOST_ASSERT(k_msgq_prio_get(&sQ, &v, NULL) == -EINVAL, "empty");
+
+    /* recycled slots serve the whole pool again */
+    (void)k_msgq_prio_set_limit(&sQ, 3, 0);
+    for (v = 0; v < SLOTS; v++) {
+        K_HOST_ASSERT(k_msgq_prio_put(&sQ, 2, &v) == 0, "reuse %u", v);
+    }
+    k_msgq_prio_purge(&sQ);
+    K_HOST_ASSERT(k_msgq_prio_get(&sQ, &v, NULL) == -EINVAL, "purged");
+}
+
+#define PRODUCERS 3
+#define PER_PRODUCER 200000U
+
+/* thread 0 consumes, the others put (producer << 24 | seq) on band
+ * seq % bands; per producer and band the sequence must only grow
+ */
+static void *stream_thread(void *arg) {
+    int id = (int)(intptr_t)arg;
+
+    if (id == 0) {
+        uint32_t last[PRODUCERS + 1][K_CONFIG_MSGQ_PRIO_BANDS] = {{0}};
+        uint32_t got = 0, v;
+        uint8_t band;
+
+        while (got < PRODUCERS * PER_PRODUCER) {
+            if (k_msgq_prio_get(&sQ, &v, &band) != 0) {
+                sched_yield();
+                continue;
+            }
+            uint32_t p = v >> 24, seq = v & 0xFFFFFFU;
+
+            K_HOST_ASSERT(p >= 1U && p <= PRODUCERS && band == seq % K_CONFIG_MSGQ_PRIO_BANDS,
+                          "bad message %x on band %u", v, band);
+            K_HOST_ASSERT(seq + 1U > last[p][band], "producer %u band %u reordered", p, band);
+            last[p][band] = seq + 1U;
+            got++;
+        }
+    } else {
+        for (uint32_t seq = 0; seq < PER_PRODUCER;) {
+            uint32_t v = ((uint32_t)id << 24) | seq;
+
+            if (k_msgq_prio_put(&sQ, (uint8_t)(seq % K_CONFIG_MSGQ_PRIO_BANDS), &v) == 0) {
+                seq++;
+            } else {
+                sched_yield();
+            }
+        }
+    }
+    return NULL;
+}
+
+int main(void) {
+    test_bands();
+    k_host_run_threads(PRODUCERS + 1, stream_thread);
+    K_HOST_PASS();
+    return 0;
+}
@@ -0,0 +1,113 @@
+/*
+ * @Date: 2026-10-22 09:12:40
+ * @FilePath: \Openy_Framework\tests\host\test_obj_stats.c
+ * @Description: K_CONFIG_OBJ_STATS counters and registry: naming, reset,
+ * high-water and full accounting, then every core registering and
+ * updating its own queues at once while another walks the registry
+ */
+#include "k_host.h"
+
+#define THREADS 4
+#define LOOPS   100000
+#define BLOCKS  20000
+
+K_MSGQ_DEFINE(sNamed, sizeof(uint32_t), 4, 4);
+
+struct item {
+    void *reserved;
+    uint32_t value;
+};
+
+static k_msgq_t sMsgq[THREADS];
+static uint32_t sMsgqBuf[THREADS][8];
+static k_queue_t sQueue[THREADS];
+static struct item sItems[THREADS][4];
+static struct k_obj_stats sBlocks[THREADS][BLOCKS];
+
+static void count_cb(const struct k_obj_stats *snapshot, void *user_data) {
+    struct k_obj_stats *sum = user_data;
+
+    K_HOST_ASSERT(snapshot->type <= K_OBJ_STATS_RING_BUF, "bad type %u", snapshot->type);
+    sum->used++;
+    sum->puts += snapshot->puts;
+    sum->gets += snapshot->gets;
+    sum->put_fails += snapshot->put_fails;
+}
+
+static struct k_obj_stats registry_sum(void) {
+    struct k_obj_stats sum;
+
+    memset(&sum, 0, sizeof(sum));
+    k_obj_stats_foreach(count_cb, &sum);
+    return sum;
+}
+
+static void test_counters(void) {
+    uint32_t v = 0;
+
+    k_obj_stats_register(&sNamed.stats, K_OBJ_STATS_MSGQ, "named");
+    K_HOST_ASSERT(registry_sum().used == 1, "one object");
+    for (int i = 0; i < 5; i++) {
+        (void)k_msgq_put(&sNamed, &v);
+    }
+    K_HOST_ASSERT(sNamed.stats.puts == 4 && sNamed.stats.put_fails == 1 &&
+                      sNamed.stats.high_water == 4 && sNamed.stats.full,
+                  "puts %u fails %u", sNamed.stats.puts, sNamed.stats.put_fails);
+    (void)k_msgq_get(&sNamed, &v);
+    (void)k_msgq_get(&sNamed, &v);
+    K_HOST_ASSERT(sNamed.stats.gets == 2 && sNamed.stats.used == 2 && !sNamed.stats.full,
+                  "gets %u used %u", sNamed.stats.gets, sNamed.stats.used);
+    k_obj_stats_reset(&sNamed.stats);
+    K_HOST_ASSERT(sNamed.stats.puts == 0 && sNamed.stats.high_water == 2 &&
+                      strcmp(sNamed.stats.name, "named") == 0,
+                  "reset");
+    k_msgq_purge(&sNamed);
+}
+
+/* each thread owns one msgq and one queue, so only the stats registry is
+ * shared; all threads also register blocks of their own, thread 0 walks
+ * the registry meanwhile
+ */
+static void *stress_thread(void *arg) {
+    int id = (int)(intptr_t)arg;
+    uint32_t v;
+
+    k_msgq_init(&sMsgq[id], (char *)sMsgqBuf[id], sizeof(uint32_t), ARRAY_SIZE(sMsgqBuf[id]));
+    k_queue_init(&sQueue[id]);
+    for (int i = 0; i < LOOPS; i++) {
+        v = (uint32_t)i;
+        (void)k_msgq_put(&sMsgq[id], &v);
+        (void)k_msgq_get(&sMsgq[id], &v);
+        k_queue_append(&sQueue[id], &sItems[id][i % 4]);
+        K_HOST_ASSERT(k_queue_get(&sQueue[id]) == &sItems[id][i % 4], "queue %d", id);
+        if (i < BLOCKS) {
+            k_obj_stats_register(&sBlocks[id][i], K_OBJ_STATS_QUEUE, NULL);
+        }
+        if (id == 0 && (i % 1024) == 0) {
+            (void)registry_sum();
+        }
+    }
+    return NULL;
+}
+
+static void test_stress(void) {
+    struct k_obj_stats sum;
+
+    k_host_run_threads(THREADS, stress_thread);
+    sum = registry_sum();
+    K_HOST_ASSERT(sum.used == 1 + THREADS * (2 + BLOCKS), "%u objects listed", sum.used);
+    K_HOST_ASSERT(sum.puts == 2U * THREADS * LOOPS && sum.gets == 2U * THREADS * LOOPS,
+                  "puts %u gets %u", sum.puts, sum.gets);
+    for (int id = 0; id < THREADS; id++) {
+        K_HOST_ASSERT(sMsgq[id].stats.used == 0 && sMsgq[id].stats.high_water == 1 &&
+                          sQueue[id].stats.used == 0,
+                      "thread %d occupancy", id);
+    }
+}
+
+int main(void) {
+    test_counters();
+    test_stress();
+    K_HOST_PASS();
+    return 0;
+}
@@ -0,0 +1,103 @@
+/*
+ * @Date: 2026-10-21 16:40:27
+ * @FilePath: \Openy_Framework\tests\host\test_run.c
+ * @Description: k_run on two cores at once: both cores register sources
+ * at the same priorities, producers on the other core post messages and
+ * work, each source is dispatched on its own core with its own scratch copy
+ */
+#include "k_host.h"
+#include "k_run.h"
+
+#define MSGS 100000U
+
+struct run_core {
+    k_msgq_t msgq;
+    uint32_t msgq_buf[8];
+    k_run_src_t msgq_src;
+    k_run_src_t work_src;
+    k_run_src_t busy_src;
+    k_work_user_t work;
+    atomic_t works;
+    uint32_t next;
+};
+
+static struct run_core sCore[2];
+static atomic_t sReady;
+static atomic_t sDone;
+
+static void run_msg(k_msgq_t *msgq, void *msg) {
+    struct run_core *rc = CONTAINER_OF(msgq, struct run_core, msgq);
+    int cpu = (int)(rc - sCore);
+
+    K_HOST_ASSERT(k_cpu_id() == cpu, "core %d dispatched the queue of core %d", k_cpu_id(), cpu);
+    K_HOST_ASSERT(*(uint32_t *)msg == rc->next, "core %d got %u, expected %u", cpu,
+                  *(uint32_t *)msg, rc->next);
+    rc->next++;
+}
+
+static void run_msg_other(k_msgq_t *msgq, void *msg) {
+    ARG_UNUSED(msgq);
+    ARG_UNUSED(msg);
+    K_HOST_ASSERT(false, "handler of a rejected add called");
+}
+
+static void run_work(k_work_user_t *work) {
+    struct run_core *rc = CONTAINER_OF(work, struct run_core, work);
+
+    K_HOST_ASSERT(k_cpu_id() == (int)(rc - sCore), "work of core %d ran on core %d",
+                  (int)(rc - sCore), k_cpu_id());
+    (void)atomic_inc(&rc->works);
+}
+
+static void *run_thread(void *arg) {
+    int cpu = (int)(intptr_t)arg;
+    struct run_core *self = &sCore[cpu], *peer = &sCore[cpu ^ 1];
+    uint32_t sent = 0;
+
+    k_msgq_init(&self->msgq, (char *)self->msgq_buf, sizeof(uint32_t), ARRAY_SIZE(self->msgq_buf));
+    self->work.handler = run_work;
+    K_HOST_ASSERT(k_run_add_msgq(&self->msgq_src, 0, 4, &self->msgq, run_msg) == 0,
+                  "core %d: msgq at priority 0", cpu);
+    K_HOST_ASSERT(k_run_add_workq(&self->work_src, 1, 4) == 0, "core %d: workq at priority 1",
+                  cpu);
+    K_HOST_ASSERT(k_run_add_workq(&self->busy_src, 0, 4) == -EBUSY, "core %d: priority 0 taken",
+                  cpu);
+    /* a rejected add leaves a registered source as it was */
+    K_HOST_ASSERT(k_run_add_msgq(&self->msgq_src, 0, 4, &peer->msgq, run_msg_other) == -EBUSY &&
+                      k_run_add_msgq(&self->msgq_src, 0, 0, &peer->msgq, run_msg_other) == -EINVAL,
+                  "core %d: re-add", cpu);
+    K_HOST_ASSERT(self->msgq_src.obj.msgq == &self->msgq && self->msgq_src.handler == run_msg &&
+                      self->msgq_src.prio == 0,
+                  "core %d: registered source changed", cpu);
+    (void)atomic_inc(&sReady);
+    while (atomic_get(&sReady) != 2) {
+        sched_yield();
+    }
+
+    while (sent < MSGS || self->next < MSGS) {
+        if (sent < MSGS && k_msgq_put(&peer->msgq, &sent) == 0) {
+            (void)k_work_user_submit_to_cpu(cpu ^ 1, &peer->work);
+            sent++;
+        }
+        if (!k_run_once()) {
+            sched_yield();
+        }
+    }
+    /* the peer's last submit may still be in flight */
+    (void)atomic_inc(&sDone);
+    while (atomic_get(&sDone) != 2) {
+        if (!k_run_once()) {
+            sched_yield();
+        }
+    }
+    while (k_run_once()) {
+    }
+    K_HOST_ASSERT(atomic_get(&self->works) > 0, "core %d ran no work", cpu);
+    return NULL;
+}
+
+int main(void) {
+    k_host_run_threads(2, run_thread);
+    K_HOST_PASS();
+    return 0;
+}
@@ -0,0 +1,133 @@
+/*
+ * @Date: 2026-10-21 13:12:05
+ * @FilePath: \Openy_Framework\tests\host\test_smp_alloc.c
+ * @Description: Framework allocations from several cores at once, built
+ * with K_CONFIG_KERNEL_MEM_SLAB, K_CONFIG_HEAP_MALLOC and
+ * K_CONFIG_MALLOC_TRACK: k_queue_alloc_append() nodes from the shared node
+ * slab and K_MALLOC/K_FREE through the tracker into the shared TLSF heap;
+ * "bench" adds pairs/sec per thread count to show the contention cost
+ */
+#include "k_host.h"
+
+#define THREADS 4
+#define LOOPS   100000
+
+static k_queue_t sQueues[THREADS];
+static atomic_t sNodesHeld;
+
+/* each thread fills its own queue until the shared node slab runs dry,
+ * then drains it checking the order
+ */
+static void *queue_thread(void *arg) {
+    int id = (int)(intptr_t)arg;
+    k_queue_t *queue = &sQueues[id];
+
+    for (int i = 0; i < LOOPS / 10; i++) {
+        uintptr_t n = 0, expect = 0;
+        void *data;
+
+        while (n < 4U && k_queue_alloc_append(queue, (void *)(n + 1U)) == 0) {
+            K_HOST_ASSERT(atomic_inc(&sNodesHeld) < K_CONFIG_QUEUE_ALLOC_NODES,
+                          "more nodes than the slab holds");
+            n++;
+        }
+        if (n == 0U) {
+            sched_yield();
+        }
+        while ((data = k_queue_get(queue)) != NULL) {
+            (void)atomic_dec(&sNodesHeld);
+            K_HOST_ASSERT((uintptr_t)data == ++expect, "thread %d got %p", id, data);
+        }
+        K_HOST_ASSERT(expect == n, "thread %d lost nodes", id);
+    }
+    return NULL;
+}
+
+static void *malloc_thread(void *arg) {
+    uint8_t id = (uint8_t)(intptr_t)arg;
+    uint8_t *held[4] = {NULL};
+    size_t size[4];
+
+    for (int i = 0; i < LOOPS; i++) {
+        int slot = i % 4;
+
+        if (held[slot] != NULL) {
+            for (size_t k = 0; k < size[slot]; k++) {
+                K_HOST_ASSERT(held[slot][k] == id, "block %p shared", (void *)held[slot]);
+            }
+            K_FREE(held[slot]);
+            held[slot] = NULL;
+        } else {
+            size[slot] = 8U + (size_t)((i * 37) % 120);
+            held[slot] = K_MALLOC(size[slot]);
+            if (held[slot] != NULL) {
+                K_HOST_ASSERT(((uintptr_t)held[slot] % K_HEAP_ALIGN_SIZE) == 0U, "alignment");
+                memset(held[slot], id, size[slot]);
+            }
+        }
+    }
+    for (int slot = 0; slot < 4; slot++) {
+        K_FREE(held[slot]);
+    }
+    return NULL;
+}
+
+static void test_queue_nodes(void) {
+    for (int i = 0; i < THREADS; i++) {
+        k_queue_init(&sQueues[i]);
+    }
+    k_host_run_threads(THREADS, queue_thread);
+    K_HOST_ASSERT(sNodesHeld == 0, "%ld nodes held", (long)sNodesHeld);
+}
+
+static void test_malloc(void) {
+    struct k_malloc_track_stats stats;
+
+    k_host_run_threads(THREADS, malloc_thread);
+    k_malloc_track_stats_get(&stats);
+    K_HOST_ASSERT(stats.cur_count == 0 && stats.cur_bytes == 0, "%u blocks left",
+                  stats.cur_count);
+    K_HOST_ASSERT(stats.total_count > (uint32_t)THREADS * LOOPS / 4U, "only %u allocations",
+                  stats.total_count);
+}
+
+static void *bench_queue_thread(void *arg) {
+    k_queue_t *queue = &sQueues[(intptr_t)arg];
+
+    for (int i = 0; i < LOOPS * 5; i++) {
+        if (k_queue_alloc_append(queue, queue) == 0) {
+            (void)k_queue_get(queue);
+        }
+    }
+    return NULL;
+}
+
+static void *bench_malloc_thread(void *arg) {
+    ARG_UNUSED(arg);
+    for (int i = 0; i < LOOPS * 5; i++) {
+        K_FREE(K_MALLOC(32));
+    }
+    return NULL;
+}
+
+static void bench(const char *name, void *(*fn)(void *)) {
+    for (int threads = 1; threads <= THREADS; threads *= 2) {
+        uint64_t t0 = k_host_ns();
+
+        k_host_run_threads(threads, fn);
+        printf("%-22s %d thread(s): %6.1f Mpairs/s\n", name, threads,
+               (double)threads * LOOPS * 5 * 1e3 / (double)(k_host_ns() - t0));
+    }
+}
+
+int main(int argc, char **argv) {
+    test_queue_nodes();
+    test_malloc();
+    K_HOST_PASS();
+
+    if (k_host_bench(argc, argv)) {
+        bench("k_queue_alloc_append", bench_queue_thread);
+        bench("K_MALLOC/K_FREE", bench_malloc_thread);
+    }
+    return 0;
+}
@@ -0,0 +1,155 @@
+/*
+ * @Date: 2026-10-22 12:20:44
+ * @FilePath: \Openy_Framework\tests\host\test_trace.c
+ * @Description: K_CONFIG_TRACE: the dump header and records, the msgq
+ * and timeout hooks, overwriting the oldest records, pausing, and two
+ * cores recording at once
+ */
+#include "k_host.h"
+
+#define CORE_EVENTS 100000
+
+K_MSGQ_DEFINE(sQ, sizeof(uint32_t), 2, 4);
+
+static struct k_trace_header sHdr;
+static struct k_trace_event sEvents[K_CONFIG_TRACE_EVENTS];
+static size_t sDumped;
+
+static void dump_write(const void *data, size_t len, void *user_data) {
+    K_HOST_ASSERT(user_data == &sDumped, "user_data");
+    if (sDumped == 0U) {
+        K_HOST_ASSERT(len == sizeof(sHdr), "header len %zu", len);
+        memcpy(&sHdr, data, len);
+    } else {
+        K_HOST_ASSERT(len == sizeof(struct k_trace_event) && sDumped <= sHdr.count, "record");
+        memcpy(&sEvents[sDumped - 1U], data, len);
+    }
+    sDumped++;
+}
+
+/* dump into sHdr and sEvents, returns the record count */
+static uint32_t dump(void) {
+    sDumped = 0;
+    k_trace_dump(dump_write, &sDumped);
+    K_HOST_ASSERT(memcmp(sHdr.magic, K_TRACE_MAGIC, 4) == 0 && sHdr.version == K_TRACE_VERSION &&
+                      sHdr.record_size == sizeof(struct k_trace_event) &&
+                      sHdr.cycles_per_sec == k_cycle_hz(),
+                  "header");
+    K_HOST_ASSERT(sDumped == 1U + sHdr.count, "%zu chunks for %u records", sDumped, sHdr.count);
+    return sHdr.count;
+}
+
+static void expect_event(int i, uint8_t id, const void *obj, uint32_t arg) {
+    const struct k_trace_event *ev = &sEvents[i];
+
+    K_HOST_ASSERT(ev->id == id && ev->obj == (uint32_t)(uintptr_t)obj && ev->arg == arg &&
+                      ev->cpu == 0U,
+                  "record %d: id %u arg %u", i, ev->id, ev->arg);
+    if (i > 0) {
+        K_HOST_ASSERT((int32_t)(ev->timestamp - sEvents[i - 1].timestamp) >= 0, "timestamp");
+    }
+}
+
+static void test_hooks(void) {
+    static struct _timeout to;
+    uint32_t x = 1;
+
+    k_trace_clear();
+    K_HOST_ASSERT(dump() == 0U, "cleared");
+
+    K_HOST_ASSERT(k_msgq_put(&sQ, &x) == 0 && k_msgq_put(&sQ, &x) == 0, "put");
+    K_HOST_ASSERT(k_msgq_put(&sQ, &x) == -ENOMEM, "full");
+    K_HOST_ASSERT(k_msgq_get(&sQ, &x) == 0, "get");
+    k_timeout_add(&to, NULL, K_TIMEOUT_TICKS(5));
+    (void)k_timeout_abort(&to);
+
+    K_HOST_ASSERT(dump() == 6U, "count %u", sHdr.count);
+    expect_event(0, K_TRACE_ID_MSGQ_PUT, &sQ, 1);
+    expect_event(1, K_TRACE_ID_MSGQ_PUT, &sQ, 2);
+    expect_event(2, K_TRACE_ID_MSGQ_FULL, &sQ, 0);
+    expect_event(3, K_TRACE_ID_MSGQ_GET, &sQ, 1);
+    expect_event(4, K_TRACE_ID_TIMEOUT_ADD, &to, 5);
+    expect_event(5, K_TRACE_ID_TIMEOUT_ABORT, &to, 0);
+    k_msgq_purge(&sQ);
+}
+
+static void test_overwrite(void) {
+    k_trace_clear();
+    for (uint32_t i = 0; i < K_CONFIG_TRACE_EVENTS + 10U; i++) {
+        K_TRACE(K_TRACE_ID_WORK_SUBMIT, &sQ, i);
+    }
+
+    /* the oldest 10 are overwritten, the rest come oldest first */
+    K_HOST_ASSERT(dump() == K_CONFIG_TRACE_EVENTS, "count %u", sHdr.count);
+    for (uint32_t i = 0; i < K_CONFIG_TRACE_EVENTS; i++) {
+        expect_event((int)i, K_TRACE_ID_WORK_SUBMIT, &sQ, i + 10U);
+    }
+}
+
+static void test_enable(void) {
+    k_trace_clear();
+    k_trace_enable(false);
+    K_TRACE(K_TRACE_ID_WORK_START, &sQ, 1);
+    /* the dump keeps recording paused */
+    K_HOST_ASSERT(dump() == 0U, "recorded while disabled");
+    K_TRACE(K_TRACE_ID_WORK_START, &sQ, 2);
+    k_trace_enable(true);
+    K_TRACE(K_TRACE_ID_WORK_END, &sQ, 3);
+    K_HOST_ASSERT(dump() == 1U, "count %u", sHdr.count);
+    expect_event(0, K_TRACE_ID_WORK_END, &sQ, 3);
+    /* and resumes it */
+    K_TRACE(K_TRACE_ID_WORK_END, &sQ, 4);
+    K_HOST_ASSERT(dump() == 2U, "count %u", sHdr.count);
+}
+
+static uint8_t sCoreObj[2];
+
+static void *core_thread(void *arg) {
+    int id = (int)(intptr_t)arg;
+
+    for (uint32_t i = 0; i < CORE_EVENTS; i++) {
+        K_TRACE(K_TRACE_ID_HSM_DISPATCH, &sCoreObj[id], i);
+        if ((i & 255U) == 0U) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void test_cores(void) {
+    uint32_t next[2] = {0, 0};
+    bool seen[2] = {false, false};
+
+    k_trace_clear();
+    k_host_run_threads(2, core_thread);
+
+    /* every kept record is whole and each core's come in its order */
+    K_HOST_ASSERT(dump() == K_CONFIG_TRACE_EVENTS, "count %u", sHdr.count);
+    for (uint32_t i = 0; i < K_CONFIG_TRACE_EVENTS; i++) {
+        const struct k_trace_event *ev = &sEvents[i];
+        int core = ev->obj == (uint32_t)(uintptr_t)&sCoreObj[1];
+
+        K_HOST_ASSERT(ev->id == K_TRACE_ID_HSM_DISPATCH && ev->cpu == (uint8_t)core &&
+                          (core == 1 || ev->obj == (uint32_t)(uintptr_t)&sCoreObj[0]),
+                      "record %u: id %u cpu %u", i, ev->id, ev->cpu);
+        K_HOST_ASSERT(!seen[core] || ev->arg >= next[core], "core %d: %u after %u", core, ev->arg,
+                      next[core]);
+        seen[core] = true;
+        next[core] = ev->arg + 1U;
+    }
+    /* the last record of each core that recorded is its last event */
+    for (int core = 0; core < 2; core++) {
+        K_HOST_ASSERT(!seen[core] || next[core] == CORE_EVENTS, "core %d ends at %u", core,
+                      next[core]);
+    }
+}
+
+int main(void) {
+    test_hooks();
+    test_overwrite();
+    test_enable();
+    test_cores();
+
+    K_HOST_PASS();
+    return 0;
+}
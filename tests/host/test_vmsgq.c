@@ -0,0 +1,54 @@
+/*
+ * @Date: 2026-10-21 16:02:18
+ * @FilePath: \Openy_Framework\tests\host\test_vmsgq.c
+ * @Description: k_vmsgq round trip, wrap padding record and the
+ * K_VMSGQ_MSG_SIZE_MAX limit on the largest buffer a queue can have
+ */
+#include "k_host.h"
+
+#define BIG_WORDS (RING_BUFFER_MAX_SIZE / 4U - 1U)
+
+K_VMSGQ_DEFINE(sQ, 16);
+K_VMSGQ_DEFINE(sBigQ, BIG_WORDS);
+
+static uint8_t sMsg[RING_BUFFER_MAX_SIZE];
+static uint8_t sOut[RING_BUFFER_MAX_SIZE];
+
+static void test_wrap(void) {
+    uint32_t size;
+    uint16_t type;
+
+    for (uint32_t i = 0; i < 20U; i++) {
+        uint32_t len = 1U + (i * 7U) % 24U;
+
+        memset(sMsg, (int)i, len);
+        K_HOST_ASSERT(k_vmsgq_put(&sQ, (uint16_t)i, sMsg, len) == 0, "put %u", i);
+        size = sizeof(sOut);
+        K_HOST_ASSERT(k_vmsgq_get(&sQ, &type, sOut, &size) == 0 && type == i && size == len &&
+                          memcmp(sOut, sMsg, len) == 0,
+                      "get %u", i);
+    }
+    K_HOST_ASSERT(k_vmsgq_is_empty(&sQ), "empty");
+}
+
+static void test_size_max(void) {
+    uint32_t size = sizeof(sOut);
+    uint16_t type;
+
+    K_HOST_ASSERT(k_vmsgq_put(&sBigQ, 1, sMsg, K_VMSGQ_MSG_SIZE_MAX + 1U) == -EMSGSIZE,
+                  "above K_VMSGQ_MSG_SIZE_MAX");
+    for (uint32_t i = 0; i < K_VMSGQ_MSG_SIZE_MAX; i++) {
+        sMsg[i] = (uint8_t)(i * 13U);
+    }
+    K_HOST_ASSERT(k_vmsgq_put(&sBigQ, 1, sMsg, K_VMSGQ_MSG_SIZE_MAX) == 0, "largest message");
+    K_HOST_ASSERT(k_vmsgq_get(&sBigQ, &type, sOut, &size) == 0 &&
+                      size == K_VMSGQ_MSG_SIZE_MAX && memcmp(sOut, sMsg, size) == 0,
+                  "largest message back, %u bytes", size);
+}
+
+int main(void) {
+    test_wrap();
+    test_size_max();
+    K_HOST_PASS();
+    return 0;
+}
@@ -0,0 +1,174 @@
+#!/usr/bin/env python3
+"""
+Decode a K_CONFIG_LOG_DICTIONARY log stream (see port/k_log.h).
+
+    k_log_decode.py firmware.elf capture.bin          print the messages
+    k_log_decode.py firmware.elf - < /dev/ttyACM0     decode a live stream
+
+The format strings are read from the .k_log_fmt section of the ELF the
+firmware was built from, %s arguments from its loaded sections.
+"""
+import argparse
+import re
+import struct
+import sys
+
+SECTION = ".k_log_fmt"
+MAGIC = 0xA5
+DROPPED = 0xFF
+HEADER = struct.Struct("<BBBBI")
+LEVELS = {0: "[INFO] ", 1: "[DEBUG] ", 2: "[ERROR] "}
+
+SHF_ALLOC = 0x2
+SHT_NOBITS = 8
+
+SPEC = re.compile(r"%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d*))?(hh|h|ll|l|z|j|t|L)?([diouxXeEfFgGaAcspn%])")
+
+
+class Elf:
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            self.data = f.read()
+        if self.data[:4] != b"\x7fELF":
+            sys.exit("%s: not an ELF file" % path)
+        is64 = self.data[4] == 2
+        end = "<" if self.data[5] == 1 else ">"
+        if is64:
+            shoff, = struct.unpack_from(end + "Q", self.data, 0x28)
+            shentsize, shnum, shstrndx = struct.unpack_from(end + "HHH", self.data, 0x3A)
+            shdr = struct.Struct(end + "IIQQQQIIQQ")
+        else:
+            shoff, = struct.unpack_from(end + "I", self.data, 0x20)
+            shentsize, shnum, shstrndx = struct.unpack_from(end + "HHH", self.data, 0x2E)
+            shdr = struct.Struct(end + "IIIIIIIIII")
+
+        raw = [shdr.unpack_from(self.data, shoff + i * shentsize) for i in range(shnum)]
+        names = raw[shstrndx][4]
+        # (name, type, flags, addr, offset, size)
+        self.sections = [(self._cstr(names + s[0]), s[1], s[2], s[3], s[4], s[5]) for s in raw]
+        self.fmt = next((s for s in self.sections if s[0] == SECTION), None)
+        if self.fmt is None:
+            sys.exit("%s: no %s section, not built with K_CONFIG_LOG_DICTIONARY" % (path, SECTION))
+
+    def _cstr(self, offset):
+        return self.data[offset:self.data.index(b"\0", offset)].decode("utf-8", "replace")
+
+    def _lookup(self, section, addr):
+        _, stype, _, base, offset, size = section
+        if stype == SHT_NOBITS or not base <= addr < base + size:
+            return None
+        return self._cstr(offset + addr - base)
+
+    def format_string(self, addr):
+        return self._lookup(self.fmt, addr)
+
+    def string(self, addr):
+        for section in self.sections:
+            if section[2] & SHF_ALLOC and section is not self.fmt:
+                s = self._lookup(section, addr)
+                if s is not None:
+                    return s
+        return "<0x%08x>" % addr
+
+
+def render(elf, fmt, words):
+    """printf() on the host, arguments taken from the 32-bit words as the target sent them"""
+    out = []
+    pos = 0
+    idx = 0
+
+    def take(n):
+        nonlocal idx
+        if idx + n > len(words):
+            raise IndexError
+        value = words[idx] if n == 1 else words[idx] | (words[idx + 1] << 32)
+        idx += n
+        return value
+
+    def signed(value, bits):
+        return value - (1 << bits) if value >> (bits - 1) else value
+
+    try:
+        for m in SPEC.finditer(fmt):
+            out.append(fmt[pos:m.start()])
+            pos = m.end()
+            flags, width, prec, length, conv = m.groups()
+            if conv == "%":
+                out.append("%")
+                continue
+            if width == "*":
+                width = str(signed(take(1), 32))
+            if prec == "*":
+                prec = str(signed(take(1), 32))
+            spec = "%" + flags + (width or "") + ("." + prec if prec is not None else "")
+
+            if conv in "eEfFgGaA":
+                value, = struct.unpack("<d", struct.pack("<Q", take(2)))
+                out.append(value.hex() if conv in "aA" else (spec + conv) % value)
+            elif conv in "diouxXc":
+                bits = 64 if length in ("ll", "j") else 32
+                value = take(bits // 32)
+                if conv in "di":
+                    out.append((spec + "d") % signed(value, bits))
+                elif conv == "c":
+                    out.append((spec + "c") % chr(value & 0xFF))
+                else:
+                    out.append((spec + ("d" if conv == "u" else conv)) % value)
+            elif conv == "s":
+                out.append((spec + "s") % elf.string(take(1)))
+            elif conv == "p":
+                out.append((spec + "s") % ("0x%08x" % take(1)))
+            else:
+                raise IndexError
+        out.append(fmt[pos:])
+    except IndexError:
+        out.append(" <truncated>")
+    return "".join(out)
+
+
+def decode(elf, data):
+    i = 0
+    while i + HEADER.size <= len(data):
+        magic, level, nwords, reserved, fmt = HEADER.unpack_from(data, i)
+        end = i + HEADER.size + nwords * 4
+        if magic != MAGIC or reserved != 0 or (level not in LEVELS and level != DROPPED) or \
+                end > len(data):
+            # lost bytes on the line, resync on the next magic
+            i += 1
+            continue
+        words = struct.unpack_from("<%dI" % nwords, data, i + HEADER.size)
+
+        if level == DROPPED:
+            yield "[ERROR] %d log messages dropped" % (words[0] if words else 0)
+        else:
+            text = elf.format_string(fmt)
+            if text is None:
+                i += 1
+                continue
+            yield LEVELS[level] + render(elf, text, words)
+        i = end
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode a dictionary log stream")
+    parser.add_argument("elf", help="ELF the firmware was built from")
+    parser.add_argument("capture", help="binary log stream, - for stdin")
+    parser.add_argument("-o", "--output", help="output file, stdout by default")
+    args = parser.parse_args()
+
+    elf = Elf(args.elf)
+    if args.capture == "-":
+        data = sys.stdin.buffer.read()
+    else:
+        with open(args.capture, "rb") as f:
+            data = f.read()
+
+    out = open(args.output, "w") if args.output else sys.stdout
+    for line in decode(elf, data):
+        out.write(line + "\n")
+    if args.output:
+        out.close()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,174 @@
+#!/usr/bin/env python3
+"""
+Decode a k_trace_dump() capture (see include/k_trace.h).
+
+    k_trace_decode.py dump.bin -o trace.json             Chrome trace_event JSON,
+                                                         open in Perfetto or chrome://tracing
+    k_trace_decode.py dump.bin --format ctf -o trace_dir CTF 1.8 (metadata + stream),
+                                                         for babeltrace or Trace Compass
+"""
+import argparse
+import json
+import os
+import struct
+import sys
+
+HEADER = struct.Struct("<4sHHII")
+RECORD = struct.Struct("<IBBHII")
+
+# enum k_trace_id
+EVENTS = {
+    1: "timeout_add",
+    2: "timeout_abort",
+    3: "timeout_expire",
+    4: "timeout_expire_end",
+    5: "work_submit",
+    6: "work_start",
+    7: "work_end",
+    8: "msgq_put",
+    9: "msgq_get",
+    10: "msgq_full",
+    11: "hsm_dispatch",
+    12: "hsm_dispatch_end",
+    13: "hsm_tran",
+}
+
+
+def load(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    magic, version, record_size, hz, count = HEADER.unpack_from(data, 0)
+    if magic != b"KTRC" or version != 1 or record_size != RECORD.size:
+        sys.exit("%s: not a k_trace dump (magic %r version %d)" % (path, magic, version))
+    if HEADER.size + count * RECORD.size > len(data):
+        sys.exit("%s: truncated, %d records announced" % (path, count))
+
+    events = []
+    last = None
+    now = 0
+    for i in range(count):
+        ts, eid, cpu, _, obj, arg = RECORD.unpack_from(data, HEADER.size + i * RECORD.size)
+        # 32-bit cycle counter: unwrap, concurrent writers may be slightly out of order
+        if last is not None:
+            delta = (ts - last) & 0xFFFFFFFF
+            now += delta - (1 << 32) if delta >= (1 << 31) else delta
+        last = ts
+        events.append((now, eid, cpu, obj, arg))
+    events.sort(key=lambda e: e[0])
+    return hz, events
+
+
+def to_chrome(hz, events):
+    out = []
+    scale = 1e6 / hz if hz else 1.0
+
+    for cycles, eid, cpu, obj, arg in events:
+        name = EVENTS.get(eid, "event_%d" % eid)
+        ev = {"pid": 0, "tid": cpu, "ts": cycles * scale}
+        if eid in (3, 4):
+            ev.update(name="timeout 0x%08x" % obj, ph="B" if eid == 3 else "E")
+        elif eid in (6, 7):
+            ev.update(name="work 0x%08x" % obj, ph="B" if eid == 6 else "E")
+        elif eid in (11, 12):
+            ev.update(name="hsm 0x%08x" % obj, ph="B" if eid == 11 else "E")
+            if eid == 11:
+                ev["args"] = {"sig": arg}
+        elif eid in (8, 9):
+            ev.update(name="msgq 0x%08x" % obj, ph="C", args={"used": arg})
+        else:
+            ev.update(name=name, ph="i", s="t", args={"obj": "0x%08x" % obj, "arg": arg})
+            if eid == 13:
+                ev["args"]["target"] = "0x%08x" % arg
+        out.append(ev)
+
+    return {"traceEvents": out, "displayTimeUnit": "ns"}
+
+
+CTF_METADATA = """/* CTF 1.8 */
+typealias integer { size = 8; align = 8; signed = false; } := uint8_t;
+typealias integer { size = 32; align = 8; signed = false; } := uint32_t;
+typealias integer { size = 64; align = 8; signed = false; } := uint64_t;
+
+trace {
+    major = 1;
+    minor = 8;
+    byte_order = le;
+    packet.header := struct {
+        uint32_t magic;
+        uint32_t stream_id;
+    };
+};
+
+clock {
+    name = cycles;
+    freq = %d;
+    offset = 0;
+};
+
+typealias integer {
+    size = 64; align = 8; signed = false;
+    map = clock.cycles.value;
+} := uint64_clock_t;
+
+stream {
+    id = 0;
+    packet.context := struct {
+        uint64_t content_size;
+        uint64_t packet_size;
+    };
+    event.header := struct {
+        uint32_t id;
+        uint64_clock_t timestamp;
+    };
+};
+"""
+
+CTF_EVENT = """
+event {
+    name = "%s";
+    id = %d;
+    stream_id = 0;
+    fields := struct {
+        uint8_t cpu;
+        uint32_t obj;
+        uint32_t arg;
+    };
+};
+"""
+
+
+def to_ctf(hz, events, directory):
+    os.makedirs(directory, exist_ok=True)
+    with open(os.path.join(directory, "metadata"), "w") as f:
+        f.write(CTF_METADATA % (hz or 1))
+        for eid, name in sorted(EVENTS.items()):
+            f.write(CTF_EVENT % (name, eid))
+
+    body = b"".join(struct.pack("<IQBII", eid, cycles, cpu, obj, arg)
+                    for cycles, eid, cpu, obj, arg in events)
+    size_bits = (8 + 16 + len(body)) * 8
+    with open(os.path.join(directory, "stream_0"), "wb") as f:
+        f.write(struct.pack("<IIQQ", 0xC1FC1FC1, 0, size_bits, size_bits))
+        f.write(body)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode a k_trace_dump() capture")
+    parser.add_argument("dump", help="binary written by k_trace_dump()")
+    parser.add_argument("-f", "--format", choices=("chrome", "ctf"), default="chrome")
+    parser.add_argument("-o", "--output", help="output file (chrome) or directory (ctf)")
+    args = parser.parse_args()
+
+    hz, events = load(args.dump)
+
+    if args.format == "ctf":
+        to_ctf(hz, events, args.output or os.path.splitext(args.dump)[0] + "_ctf")
+    elif args.output:
+        with open(args.output, "w") as f:
+            json.dump(to_chrome(hz, events), f, indent=1)
+    else:
+        json.dump(to_chrome(hz, events), sys.stdout, indent=1)
+
+
+if __name__ == "__main__":
+    main()